@@ -0,0 +1,249 @@
+#!/bin/bash
+#
+#	File:		bench-cli.sh
+#	Author:		Alin Tomescu, tomescu.alin@gmail.com
+#	Website:	http://alinush.org
+#	Date: 		October 16th, 2026
+#	License:	Free to use and distribute as long as this notice is kept.
+#
+# Times the base64 tool next to this script against the system's base64, end to end: startup,
+# then /encode and /decode on files of every size, with the input warm and cold in the page
+# cache. Prints one CSV row per run, with the wall, user and sys times, the peak RSS and the
+# number of system calls, where the tools to measure them are available. The status column
+# says whether the run failed, or its output doesn't give back the plain file: as is for the
+# decodes, and decoded by the system's base64 for the encodes.
+#
+# The corpora are random files kept in the work directory, so later runs reuse them. Each tool
+# decodes its own encoding: 76-character lines ending in \r\n for bin/base64, in \n for the
+# system's base64. Throughput is in MB of plain data per second, for both directions.
+
+usage()
+{
+	echo "usage: $0 [-s \"<sizes>\"] [-r <runs>] [-j <threads>] [-w <work dir>] [-o <csv file>]"
+	echo
+	echo "  -s  the sizes of the files to encode and decode (\"1K 1M 100M 1G 10G\" by default),"
+	echo "      where K, M and G are powers of 1024"
+	echo "  -r  the number of runs of every measurement (3 by default)"
+	echo "  -j  the number of threads of the multithreaded runs of bin/base64 (the number of CPUs by default)"
+	echo "  -w  the directory for the corpora and the outputs (/tmp/base64-bench by default)"
+	echo "  -o  the CSV file to write the results to (the standard output by default)"
+	exit 1
+}
+
+BINDIR=$(cd "$(dirname "$0")" && pwd)
+TOOL=$BINDIR/base64
+SIZES="1K 1M 100M 1G 10G"
+RUNS=3
+THREADS=$(nproc 2>/dev/null || echo 4)
+WORKDIR=/tmp/base64-bench
+OUTPUT=/dev/stdout
+
+while getopts "s:r:j:w:o:h" opt; do
+	case $opt in
+		s) SIZES=$OPTARG ;;
+		r) RUNS=$OPTARG ;;
+		j) THREADS=$OPTARG ;;
+		w) WORKDIR=$OPTARG ;;
+		o) OUTPUT=$OPTARG ;;
+		*) usage ;;
+	esac
+done
+
+# The bin/base64 in git is an old build, so build the current sources first.
+if ! make -C "$BINDIR/../src" main >&2; then
+	echo "Could not build $TOOL with 'make main' in src/." >&2
+	exit 1
+fi
+
+if ! command -v base64 >/dev/null; then
+	echo "The system's base64 was not found." >&2
+	exit 1
+fi
+
+mkdir -p "$WORKDIR" || exit 1
+
+# Times a command, with its standard output going to the specified file, and prints
+# "<wall> <user> <sys> <peak RSS in KB>". Fails if the command does. Python gives the most precise times and the peak
+# RSS, GNU time the peak RSS with times to 10 ms, and bash's own time keyword no RSS at all.
+#
+# Python waits for the command with wait4, which gives the usage of that process alone,
+# rather than of every child Python (or a wrapper script that execs it) ever had.
+PYTHON_MEASURE='
+import os, subprocess, sys, time
+with open(sys.argv[1], "wb") as out:
+	start = time.perf_counter()
+	child = subprocess.Popen(sys.argv[2:], stdout=out)
+	pid, status, usage = os.wait4(child.pid, 0)
+	child.returncode = status
+	wall = time.perf_counter() - start
+print("%.6f %.6f %.6f %d" % (wall, usage.ru_utime, usage.ru_stime, usage.ru_maxrss))
+sys.exit(1 if status != 0 else 0)
+'
+
+measure()
+{
+	local out=$1
+	shift
+
+	if command -v python3 >/dev/null; then
+		python3 -c "$PYTHON_MEASURE" "$out" "$@"
+	elif [ -x /usr/bin/time ] && /usr/bin/time --version >/dev/null 2>&1; then
+		local status=0
+		/usr/bin/time -f "%e %U %S %M" -o "$WORKDIR/time.txt" "$@" > "$out" || status=$?
+		tail -n 1 "$WORKDIR/time.txt"
+		return $status
+	else
+		local TIMEFORMAT="%R %U %S NA"
+		{ time "$@" > "$out" 2>/dev/null; } 2>&1
+	fi
+}
+
+# Prints the number of system calls a command makes, or NA without strace.
+count_syscalls()
+{
+	local out=$1
+	shift
+
+	if command -v strace >/dev/null; then
+		strace -f -c -q -o "$WORKDIR/strace.txt" "$@" > "$out"
+		awk '$NF == "total" { print $4 }' "$WORKDIR/strace.txt"
+	else
+		echo NA
+	fi
+}
+
+# Drops a file from the page cache, with GNU dd's nocache flag, which doesn't need root.
+evict()
+{
+	dd if="$1" iflag=nocache count=0 status=none 2>/dev/null
+}
+
+# Converts a size like 10G to bytes.
+to_bytes()
+{
+	numfmt --from=iec "$1"
+}
+
+# Tells whether the output of an encode or a decode gives back the plain file. Encodings are
+# decoded by the system's base64, which only needs the \r of \r\n newlines dropped.
+verify()
+{
+	local operation=$1 output=$2 plain=$3
+
+	if [ "$operation" = encode ]; then
+		tr -d '\r' < "$output" | base64 -d 2>/dev/null | cmp -s - "$plain"
+	else
+		cmp -s "$plain" "$output"
+	fi
+}
+
+# Benchmarks one command on one file, warm and cold, and prints its rows. The output file is
+# deleted before every run; the command writes it itself, or to its standard output, which goes
+# to the specified file (the output file or /dev/null). After every run, the output is checked
+# against the plain file.
+#
+#	bench <tool> <operation> <size> <input> <output> <stdout> <plain> <command...>
+bench()
+{
+	local tool=$1 operation=$2 size=$3 input=$4 output=$5 stdout=$6 plain=$7
+	shift 7
+
+	rm -f "$output"
+	local syscalls
+	syscalls=$(count_syscalls "$stdout" "$@")
+
+	for cache in warm cold; do
+		for run in $(seq 1 "$RUNS"); do
+			rm -f "$output"
+			if [ $cache = cold ]; then
+				evict "$input"
+			else
+				cat "$input" > /dev/null
+			fi
+
+			local times status=ok
+			if ! times=$(measure "$stdout" "$@"); then
+				status=failed
+				echo "$tool failed to $operation the $size file." >&2
+			elif ! verify "$operation" "$output" "$plain"; then
+				status=mismatch
+				echo "$tool did not $operation the $size file correctly." >&2
+			fi
+
+			read -r wall user sys rss <<< "$times"
+			local rate
+			rate=$(awk -v size="$size" -v wall="$wall" 'BEGIN { if(wall > 0) printf "%.1f", size / wall / 1048576; else print "NA" }')
+			echo "$tool,$operation,$size,$cache,$run,$wall,$user,$sys,$rss,$syscalls,$rate,$status" >> "$OUTPUT"
+		done
+	done
+}
+
+echo "tool,operation,size,cache,run,wall_s,user_s,sys_s,max_rss_kb,syscalls,mb_per_s,status" > "$OUTPUT"
+
+# Startup: the average wall time of encoding a 1-byte file, over 100 runs. The row fails if
+# any run does, and the last run's output is checked like bench does.
+head -c 1 /dev/urandom > "$WORKDIR/startup.bin"
+for tool in bin/base64 coreutils; do
+	status=ok
+	rm -f "$WORKDIR/startup.b64"
+	start=$EPOCHREALTIME
+	for i in $(seq 1 100); do
+		if [ $tool = coreutils ]; then
+			base64 "$WORKDIR/startup.bin" > "$WORKDIR/startup.b64" || status=failed
+		else
+			"$TOOL" /encode "$WORKDIR/startup.bin" "$WORKDIR/startup.b64" || status=failed
+		fi
+	done
+	wall=$(awk -v start="$start" -v end="$EPOCHREALTIME" 'BEGIN { printf "%.6f", (end - start) / 100 }')
+
+	if [ $status = failed ]; then
+		echo "$tool failed to encode the startup file." >&2
+	elif ! verify encode "$WORKDIR/startup.b64" "$WORKDIR/startup.bin"; then
+		status=mismatch
+		echo "$tool did not encode the startup file correctly." >&2
+	fi
+
+	echo "$tool,startup,1,warm,1,$wall,NA,NA,NA,NA,NA,$status" >> "$OUTPUT"
+done
+
+# The memory of the process that runs a command counts towards the peak RSS of the command,
+# up to its exec, so the peak RSS of running true is the floor of the other measurements.
+read -r wall user sys rss <<< "$(measure /dev/null true)"
+echo "true,baseline,0,warm,1,$wall,$user,$sys,$rss,NA,NA,ok" >> "$OUTPUT"
+
+for size in $SIZES; do
+	bytes=$(to_bytes "$size") || exit 1
+	plain=$WORKDIR/plain-$size.bin
+
+	# The plain file, two encodings and a decoded copy must fit on the disk.
+	available=$(( $(df -Pk "$WORKDIR" | awk 'NR == 2 { print $4 }') * 1024 ))
+	needed=$(( bytes * 4 + bytes / 2 ))
+	if [ ! -f "$plain" ]; then
+		needed=$(( needed + bytes ))
+	fi
+
+	if [ "$available" -lt "$needed" ]; then
+		echo "Not enough disk space in $WORKDIR for the $size files, skipping them." >&2
+		continue
+	fi
+
+	if [ "$(stat -c %s "$plain" 2>/dev/null)" != "$bytes" ]; then
+		head -c "$bytes" /dev/urandom > "$plain"
+	fi
+
+	ours=$WORKDIR/ours-$size.b64
+	theirs=$WORKDIR/theirs-$size.b64
+	decoded=$WORKDIR/decoded-$size.bin
+
+	bench bin/base64 encode "$bytes" "$plain" "$ours" /dev/null "$plain" "$TOOL" /encode "$plain" "$ours"
+	bench bin/base64-mmap encode "$bytes" "$plain" "$ours" /dev/null "$plain" "$TOOL" --mmap /encode "$plain" "$ours"
+	bench "bin/base64-j$THREADS" encode "$bytes" "$plain" "$ours" /dev/null "$plain" "$TOOL" -j "$THREADS" /encode "$plain" "$ours"
+	bench coreutils encode "$bytes" "$plain" "$theirs" "$theirs" "$plain" base64 -w 76 "$plain"
+
+	bench bin/base64 decode "$bytes" "$ours" "$decoded" /dev/null "$plain" "$TOOL" /decode "$ours" "$decoded"
+	bench bin/base64-mmap decode "$bytes" "$ours" "$decoded" /dev/null "$plain" "$TOOL" --mmap /decode "$ours" "$decoded"
+	bench "bin/base64-j$THREADS" decode "$bytes" "$ours" "$decoded" /dev/null "$plain" "$TOOL" -j "$THREADS" /decode "$ours" "$decoded"
+	bench coreutils decode "$bytes" "$theirs" "$decoded" "$decoded" "$plain" base64 -d "$theirs"
+
+	rm -f "$ours" "$theirs" "$decoded"
+done
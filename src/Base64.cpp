@@ -7,213 +7,355 @@
  */
 #include "Base64.h"
 
-#include <cctype>
 #include <cstring>
 #include <sstream>
 #include <stdexcept>
 #include <fstream>
+#include <cstdlib>
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
 
 /**
- * This table maps every 6-bit number (0 through 63) to an ASCII character.
- * This table stores the base64 alphabet.
+ * The names of the backends, which the BASE64_BACKEND environment variable can be set to.
  */
-const char Base64::_byteToChar[64] = 
+const char * const Base64Common::_backendNames[NUM_BACKENDS] = { "scalar", "swar", "ssse3", "avx2", "avx512" };
+
+/**
+ * The kernels of every backend. The wider kernels leave a few blocks behind,
+ * so the narrower ones get a go at those before the scalar code takes over.
+ */
+template <class Alphabet>
+const typename BasicBase64<Alphabet>::Kernels BasicBase64<Alphabet>::_kernels[NUM_BACKENDS] =
 {
-	/**
-	 * Uppercase letters (from 0 to 25)
-	 */
-	'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 
-	'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z',
+	{ { NULL }, { NULL }, { NULL }, NULL },
+	{ { encodeSwar, NULL }, { decodeSwar, NULL }, { NULL }, NULL },
+	{ { encodeSsse3, encodeSwar, NULL }, { decodeSwar, NULL }, { validateSsse3, NULL }, compactSsse3 },
+	{ { encodeAvx2, encodeSsse3, encodeSwar, NULL }, { decodeAvx2, decodeSwar, NULL }, { validateAvx2, validateSsse3, NULL },
+		compactSsse3 },
+	{ { encodeAvx512, encodeAvx2, encodeSsse3, encodeSwar }, { decodeAvx512, decodeAvx2, decodeSwar, NULL },
+		{ validateAvx512, validateAvx2, validateSsse3, NULL }, compactSsse3 }
+};
+
+/**
+ * The backend in use, or -1 if none was picked yet.
+ */
+static std::atomic<int> g_backend(-1);
+
+/**
+ * Returns the fastest backend supported by the CPU, by checking the CPU's feature flags
+ * and, for the AVX backends, that the operating system saves the vector registers.
+ * The SWAR backend runs anywhere, so it's the fallback when there's no SIMD support.
+ */
+static Base64Common::Backend detectBackend()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	uint eax, ebx, ecx, edx;
+	if(!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+		return Base64Common::SWAR;
 	
-	/**
-	 * Lowercase letters (from 26 to 51)
-	 */
-	'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 
-	'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',
+	bool ssse3 = ecx & bit_SSSE3;
+	if(!(ecx & bit_AVX) || !(ecx & bit_OSXSAVE))
+		return ssse3 ? Base64Common::SSSE3 : Base64Common::SWAR;
+	
+	uint xcr0, xcr0High;
+	__asm__ ("xgetbv" : "=a" (xcr0), "=d" (xcr0High) : "c" (0));
 	
 	/**
-	 * Digits (from 52 to 61)
+	 * The OS must save the SSE and AVX state (bits 1 and 2) for AVX2, and
+	 * the opmask and ZMM state (bits 5 to 7) as well for AVX-512.
 	 */
-	'0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+	bool ymmState = (xcr0 & 0x06) == 0x06;
+	bool zmmState = (xcr0 & 0xE6) == 0xE6;
+	
+	if(!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+		return ssse3 ? Base64Common::SSSE3 : Base64Common::SWAR;
 	
 	/**
-	 * Misc. (from 62 to 63)
+	 * Each backend also runs the kernels of the backends below it on what its own kernels
+	 * leave behind, so it needs their instruction sets too. A hypervisor can mask AVX2 or
+	 * SSSE3 while still exposing AVX-512.
 	 */
-	'+', '/'
-};
+	bool avx2 = ymmState && ssse3 && (ebx & bit_AVX2);
+	
+	if(avx2 && zmmState && (ebx & bit_AVX512F) && (ebx & bit_AVX512BW) && (ecx & bit_AVX512VBMI))
+		return Base64Common::AVX512;
+	if(avx2)
+		return Base64Common::AVX2;
+	
+	return ssse3 ? Base64Common::SSSE3 : Base64Common::SWAR;
+#else
+	return Base64Common::SWAR;
+#endif
+}
 
-/**
- * The padding character is used to fill the remaining characters in the
- * base64 encoded block, when the input block is less than 3 bytes long.
- */
-const char Base64::_paddingChar = '=';
+Base64Common::Backend Base64Common::getBestBackend()
+{
+	static const Backend best = detectBackend();
+	return best;
+}
 
-bool Base64::isValidEncoding(const char * buffer, ulong length)
+bool Base64Common::isBackendSupported(Backend backend)
 {
-	//	Ensure string length is a multiple of 4
-	if(length % 4)
-		return false;
-		
-	//	Ensure string is only made up of base64 arguments
-	for(uint i = 0; i < length; i++)
-	{
-		if(!isalnum(buffer[i]) && 
-			buffer[i] != '+' && 
-			buffer[i] != '/' && 
-			buffer[i] != _paddingChar)
-			return false;
-	}
+	return backend >= SCALAR && backend <= getBestBackend();
+}
+
+const char * Base64Common::getBackendName(Backend backend)
+{
+	if(backend < SCALAR || backend >= NUM_BACKENDS)
+		return "unknown";
 	
-	if(length != 0)
+	return _backendNames[backend];
+}
+
+Base64Common::Backend Base64Common::getBackend()
+{
+	int backend = g_backend.load(std::memory_order_acquire);
+	
+	if(backend < 0)
 	{
-		//	Ensure string only has padding characters on the last 2 positions
-		for(uint i = 0; i < length - 2; i++)
+		/**
+		 * Pick the fastest backend, unless the environment asks for a specific one.
+		 * Threads racing through here all pick the same one, so there's no need for a lock.
+		 */
+		backend = getBestBackend();
+		
+		const char * name = getenv("BASE64_BACKEND");
+		for(int i = SCALAR; name != NULL && i < NUM_BACKENDS; i++)
 		{
-			if(buffer[i] == _paddingChar)
-				return false;
+			if(strcmp(name, _backendNames[i]) == 0 && isBackendSupported(static_cast<Backend>(i)))
+				backend = i;
 		}
 		
-		//	Ensure that the if the second to last character is a padding char, then the 
-		//	last character is also a padding char
-		if(buffer[length - 2] == _paddingChar && buffer[length - 1] != _paddingChar)
-			return false;
+		g_backend.store(backend, std::memory_order_release);
 	}
 	
-	return true;
+	return static_cast<Backend>(backend);
 }
 
-void Base64::encodeBlock(const byte in[3], char out[4], uint inLength)
+void Base64Common::setBackend(Backend backend)
 {
+	if(!isBackendSupported(backend))
+	{
+		std::ostringstream error;
+		error << "The " << getBackendName(backend) << " backend is not supported by this CPU.";
+		throw std::runtime_error(error.str());
+	}
+	
+	g_backend.store(backend, std::memory_order_release);
+}
+
+template <class Alphabet>
+const typename BasicBase64<Alphabet>::Kernels & BasicBase64<Alphabet>::kernels()
+{
+	return _kernels[getBackend()];
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeKernels(const byte * in, char * out, ulong inSize)
+{
+	const Kernels & k = kernels();
+	ulong done = 0;
+	
+	for(uint i = 0; i < _maxKernels && k.encode[i] != NULL; i++)
+		done += k.encode[i](in + done, out + done / 3 * 4, inSize - done);
+	
+	return done;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeKernels(const char * in, byte * out, ulong inSize)
+{
+	const Kernels & k = kernels();
+	ulong done = 0;
+	
+	for(uint i = 0; i < _maxKernels && k.decode[i] != NULL; i++)
+		done += k.decode[i](in + done, out + done / 4 * 3, inSize - done);
+	
+	return done;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::validateKernels(const char * in, ulong inSize)
+{
+	const Kernels & k = kernels();
+	ulong done = 0;
+	
+	for(uint i = 0; i < _maxKernels && k.validate[i] != NULL; i++)
+		done += k.validate[i](in + done, inSize - done);
+	
+	return done;
+}
+
+template <class Alphabet>
+bool BasicBase64<Alphabet>::isValidEncoding(const char * buffer, ulong length)
+{
+	return validateEncoding(buffer, length).error == DECODE_OK;
+}
+
+template <class Alphabet>
+typename BasicBase64<Alphabet>::DecodeResult BasicBase64<Alphabet>::validateEncoding(const char * in,
+	ulong inSize) noexcept
+{
+	StatsScope stats(VALIDATE_ENCODING, inSize);
+	
+	if(!isValidLength(inSize))
+		return stats.finish(DecodeResult { INVALID_LENGTH, inSize, 0 });
+	
+	if(inSize == 0)
+		return stats.finish(DecodeResult { DECODE_OK, 0, 0 });
+	
 	/**
-	 * Encoding three bytes works by splitting the 3 x 8 = 24 byte block
-	 * into 4 blocks of 6 bytes. This is done using bitwise operations. Each one of the
-	 * resulting 4 blocks will represent a number in the 0 to 63 range. 
-	 * Each number is associated with a character in the base64 table.
-	 * 
-	 * Once we transform the 3 bytes into the 4 6-bit numbers, we'll replace the
-	 * 4 6-bit numbers by their corresponding characters in the table and get
-	 * the final base64 encoded block.
-	 *
-	 *	Of course, you also have to deal with padding, which involves a few checks.
+	 * Every block but the last one is checked by the kernels of the backend in use, and
+	 * whatever they leave behind by OR'ing the looked up values into a sentinel, the same
+	 * way decodeFused does it.
 	 */
+	ulong lastSize = inSize % 4 ? inSize % 4 : 4;
+	ulong done = validateKernels(in, inSize - lastSize);
+	byte sentinel = 0;
 	
-	out[0] = byteToChar(in[0] >> 2);
-	out[2] = out[3] = Base64::_paddingChar;
+	for(ulong i = done; i < inSize - lastSize; i++)
+		sentinel |= _tables.charToByte[static_cast<byte>(in[i])];
 	
-	out[1] = byteToChar(
-		((in[0] & 0x03) << 4) |
-		(inLength > 1 ? (((in[1] & 0xF0)) >> 4) : 0)
-	);
+	if(sentinel & 0x80)
+	{
+		for(ulong i = done; i < inSize - lastSize; i++)
+		{
+			if(_tables.charToByte[static_cast<byte>(in[i])] == _invalidChar)
+				return stats.finish(DecodeResult { INVALID_CHARACTER, i, 0 });
+		}
+	}
+	
+	/**
+	 * Only the last block can end in padding characters.
+	 */
+	const char * last = in + inSize - lastSize;
+	uint nPadding = 4 - lastSize;
+	if(Alphabet::padding && last[3] == _paddingChar)
+		nPadding = last[2] == _paddingChar ? 2 : 1;
 	
-	if(inLength >= 2)
+	for(uint i = 0; i < 4 - nPadding; i++)
 	{
-		out[2] = byteToChar(
-			((in[1] & 0x0F) << 2) | 
-			(inLength == 3 ? ((in[2] & 0xC0) >> 6) : 0)
-		);
-		
-		if(inLength == 3)
-			out[3] = byteToChar(in[2] & 0x3F);
+		if(_tables.charToByte[static_cast<byte>(last[i])] == _invalidChar)
+			return stats.finish(DecodeResult { INVALID_CHARACTER, inSize - lastSize + i, 0 });
 	}
+	
+	return stats.finish(DecodeResult { DECODE_OK, 0, (inSize - lastSize) / 4 * 3 + 3 - nPadding });
 }
 
-uint Base64::decodeBlock(const char in[4], byte out[3]) throw (std::runtime_error)
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeFused(const char * in, byte * out, ulong inSize, ulong & decodedLength)
 {
+	decodedLength = 0;
+	if(inSize == 0)
+		return 0;
+
 	/**
-	 *	Decoding a 4-character blocks is just the reverse of encoding. You look at each character
-	 *	and get its offset in the base64 alphabet. This will be a 6 bit number. You do this for all
-	 *	4 characters and you'll get 6 x 4 = 24 bits = 3 bytes. These 3 bytes obtained by concatenating
-	 *	all those 6 bits will be the decoded data.
-	 *
-	 *	Of course, you also have to deal with padding, which involves a few checks.
+	 * Let the vectorized kernels of the backend in use, if any, decode the
+	 * bulk of the input. They stop early if they run into an invalid character.
 	 */
-	 
+	ulong vectorSize = decodeKernels(in, out, inSize);
+
 	/**
-	 * The length of the decoded data will be stored here
-	 * and returned when the function exits.
+	 * Only the last block can have padding characters, or be a partial block without
+	 * padding, so every block before it is decoded without any checks. The looked up
+	 * values are OR'ed into the sentinel, which will have its high bit set if any
+	 * character was invalid.
 	 */
-	uint length = 0;
-	
-	out[0] = (charToByte(in[0]) << 2) | ((charToByte(in[1]) & 0x30) >> 4);
-	out[1] = ((charToByte(in[1]) & 0x0F) << 4);
-	length += 2;
+	ulong lastSize = inSize % 4 ? inSize % 4 : 4;
+	ulong nChunks = (inSize - vectorSize - lastSize) / 4;
+	const byte * inPtr = reinterpret_cast<const byte *>(in + vectorSize);
+	byte * outPtr = out + vectorSize / 4 * 3;
+	byte sentinel = 0;
+
+	for(ulong i = 0; i < nChunks; i++)
+	{
+		byte a = _tables.charToByte[inPtr[0]];
+		byte b = _tables.charToByte[inPtr[1]];
+		byte c = _tables.charToByte[inPtr[2]];
+		byte d = _tables.charToByte[inPtr[3]];
+		sentinel |= a | b | c | d;
+
+		outPtr[0] = (a << 2) | (b >> 4);
+		outPtr[1] = (b << 4) | (c >> 2);
+		outPtr[2] = (c << 6) | d;
+
+		inPtr += 4;
+		outPtr += 3;
+	}
 
 	/**
-	 * If the 3rd input char is not a padding char, then go ahead and
-	 * decode it, storing it in the remaining part of the 2nd output byte.
+	 * Only now, if an invalid character was seen, go back and find the first one.
 	 */
-	if(in[2] != Base64::_paddingChar)
+	if(sentinel & 0x80)
 	{
-		out[1] |= ((charToByte(in[2]) & 0x3C) >> 2);
-		
-		/**
-		 * If the 4th input char is also not a padding char, then go ahead and decode it,
-		 * storing it in the 3rd output byte.
-		 */
-		if(in[3] != Base64::_paddingChar)
+		for(ulong i = vectorSize; i < inSize - lastSize; i++)
 		{
-			out[2] = ((charToByte(in[2]) & 0x03) << 6) | (charToByte(in[3]) & 0x3F);
-			length += 1;
+			if(_tables.charToByte[static_cast<byte>(in[i])] == _invalidChar)
+				return i;
 		}
 	}
+
 	/**
-	 * Otherwise, if the 3rd input char is a padding char, 
-	 * then make sure the 4th one is also a padding char.
+	 * The last block may end in one or two padding characters, or be missing them
+	 * altogether without padding. The characters before the padding are looked up
+	 * just like above; a padding character in any other position is looked up too,
+	 * and will be caught as an invalid character.
 	 */
-	else if(in[3] != Base64::_paddingChar)
+	uint nPadding = 4 - lastSize;
+	if(Alphabet::padding && inPtr[3] == _paddingChar)
+		nPadding = inPtr[2] == _paddingChar ? 2 : 1;
+
+	byte last[4] = { 0, 0, 0, 0 };
+	for(uint i = 0; i < 4 - nPadding; i++)
 	{
-		std::ostringstream error("Non-padding char encountered immediately after padding char: ");
-		error << in[3] << "(ASCII code: " << static_cast<unsigned short>(in[3]) << ")";
-		throw std::runtime_error(error.str());
+		last[i] = _tables.charToByte[inPtr[i]];
+		if(last[i] == _invalidChar)
+			return inSize - lastSize + i;
 	}
-	
-	return length;
+
+	outPtr[0] = (last[0] << 2) | (last[1] >> 4);
+	if(nPadding < 2)
+		outPtr[1] = (last[1] << 4) | (last[2] >> 2);
+	if(nPadding < 1)
+		outPtr[2] = (last[2] << 6) | last[3];
+
+	decodedLength = (inSize - lastSize) / 4 * 3 + 3 - nPadding;
+	return inSize;
 }
 
-byte Base64::charToByte(char ch) throw (std::runtime_error)
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeBuffer(const byte * in, char * out, ulong inSize)
 {
-	if(ch == '+')
-		return 62;
-	else if(ch == '/')
-		return 63;
-	else if(isdigit(ch))
-		return 52 + (ch - '0');
-	else if(isalpha(ch))
-	{
-		if(isupper(ch))
-			return ch - 'A';
-		else
-			return 26 + (ch - 'a');
-	}
-	else
-	{
-		std::ostringstream error("Invalid character detected in the base64-encoded input: ");
-		error << ch << "(ASCII code: " << static_cast<unsigned short>(ch) << ")";
-		throw std::runtime_error(error.str());
-	}
+	StatsScope stats(ENCODE_BUFFER, inSize);
 	
-}
+	/**
+	 * Let the vectorized kernels of the backend in use, if any, encode the bulk
+	 * of the input.
+	 */
+	ulong vectorSize = encodeKernels(in, out, inSize);
+	ulong vectorLength = vectorSize / 3 * 4;
 
-ulong Base64::encodeBuffer(const byte * in, char * out, ulong inSize)
-{
 	/**
-	 * Compute the number of 3 byte chunks and, if the
+	 * Compute the number of 3 byte chunks left and, if the
 	 * last chunk is less than 3 bytes, compute its size also.
 	 */
-	uint nChunks = inSize / 3;
+	ulong nChunks = (inSize - vectorSize) / 3;
 	uint lastChunkSize = inSize % 3;
-	
+
 	/**
 	 * Get two pointers to the input and output buffers.
 	 */
-	const byte * inPtr = in;
-	char * outPtr = out;
+	const byte * inPtr = in + vectorSize;
+	char * outPtr = out + vectorLength;
 	
 	/**
 	 * For each chunk of 3 bytes, encode it in base 64,
 	 * and advance the input and output pointers into the buffers.
 	 */
-	for(uint i = 0; i < nChunks; i++)
+	for(ulong i = 0; i < nChunks; i++)
 	{
 		encodeBlock(inPtr, outPtr, 3);
 		//std::cout << "In: " << inPtr[0] << inPtr[1] << inPtr[2] << std::endl;
@@ -228,67 +370,368 @@ ulong Base64::encodeBuffer(const byte * in, char * out, ulong inSize)
 	if(lastChunkSize > 0)
 	{
 		encodeBlock(inPtr, outPtr, lastChunkSize);
-		return (nChunks + 1) * 4;
+		return stats.finish(vectorLength + nChunks * 4 + (Alphabet::padding ? 4 : lastChunkSize + 1));
 	}
 	else
-		return nChunks * 4;
+		return stats.finish(vectorLength + nChunks * 4);
 }
 
-ulong Base64::decodeBuffer(const char * in, byte * out, ulong inSize) throw (std::runtime_error)
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeBuffer(const char * in, byte * out, ulong inSize)
 {
+	DecodeResult result = tryDecodeBuffer(in, out, inSize);
+	if(result.error != DECODE_OK)
+		throw decodeError(result, in);
+
+	return result.length;
+}
+
+template <class Alphabet>
+typename BasicBase64<Alphabet>::DecodeResult BasicBase64<Alphabet>::tryDecodeBuffer(const char * in, byte * out,
+	ulong inSize) noexcept
+{
+	StatsScope stats(DECODE_BUFFER, inSize);
+	
 	/**
-	 * The length of the input base64-encoded line needs to be a multiple of 4.
+	 * The length of the input base64-encoded line needs to be a multiple of 4,
+	 * except for the partial last block of unpadded encodings.
 	 */
-	if(inSize % 4)
+	if(!isValidLength(inSize))
+		return stats.finish(DecodeResult { INVALID_LENGTH, inSize, 0 });
+	
+	/**
+	 * Validate and decode the whole buffer in one pass.
+	 */
+	ulong decodedLength;
+	ulong errorOffset = decodeFused(in, out, inSize, decodedLength);
+
+	if(errorOffset != inSize)
+		return stats.finish(DecodeResult { INVALID_CHARACTER, errorOffset, 0 });
+
+	return stats.finish(DecodeResult { DECODE_OK, 0, decodedLength });
+}
+
+template <class Alphabet>
+std::string BasicBase64<Alphabet>::encode(std::span<const std::byte> in)
+{
+	std::string out(getEncodedSize(in.size()), '\0');
+	encodeBuffer(reinterpret_cast<const byte *>(in.data()), out.data(), in.size());
+	return out;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeInto(std::span<const std::byte> in, std::span<char> out)
+{
+	if(out.size() < getEncodedSize(in.size()))
 	{
 		std::ostringstream error;
-		error << "The length of the base64-encoded line (" << inSize << ") is not a multiple of 4.";
+		error << "The output buffer (" << out.size() << " characters) is too small for the base64 encoding ("
+			<< getEncodedSize(in.size()) << " characters).";
 		throw std::runtime_error(error.str());
 	}
 	
-	if(!isValidEncoding(in, inSize))
+	return encodeBuffer(reinterpret_cast<const byte *>(in.data()), out.data(), in.size());
+}
+
+template <class Alphabet>
+std::vector<std::byte> BasicBase64<Alphabet>::decode(std::string_view in)
+{
+	std::vector<std::byte> out(getDecodedSize(in.data(), in.size()));
+	decodeBuffer(in.data(), reinterpret_cast<byte *>(out.data()), in.size());
+	return out;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeInto(std::string_view in, std::span<std::byte> out)
+{
+	DecodeResult result = tryDecode(in, out);
+	if(result.error != DECODE_OK)
+		throw decodeError(result, in.data());
+
+	return result.length;
+}
+
+template <class Alphabet>
+typename BasicBase64<Alphabet>::DecodeResult BasicBase64<Alphabet>::tryDecode(std::string_view in,
+	std::span<std::byte> out) noexcept
+{
+	StatsScope stats(DECODE_BUFFER, in.size());
+	
+	if(!isValidLength(in.size()))
+		return stats.finish(DecodeResult { INVALID_LENGTH, in.size(), 0 });
+
+	/**
+	 * The decoding kernels never write past the exact decoded size, so the caller
+	 * doesn't need to leave room for the bytes the padding stands for.
+	 */
+	ulong decodedSize = getDecodedSize(in.data(), in.size());
+	if(out.size() < decodedSize)
+		return stats.finish(DecodeResult { OUTPUT_TOO_SMALL, 0, decodedSize });
+
+	return stats.finish(tryDecodeBuffer(in.data(), reinterpret_cast<byte *>(out.data()), in.size()));
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeInPlace(std::span<std::byte> buffer, ulong inSize)
+{
+	StatsScope stats(ENCODE_BUFFER, inSize);
+	
+	if(buffer.size() < getEncodedSize(inSize))
 	{
-		throw std::runtime_error("The input string is not a valid base64 encoding");
+		std::ostringstream error;
+		error << "The buffer (" << buffer.size() << " bytes) is too small to encode " << inSize
+			<< " bytes in place, which takes " << getEncodedSize(inSize) << " bytes.";
+		throw std::runtime_error(error.str());
 	}
 	
 	/**
-	 * The number of 4-byte base64-encoded chunks.
+	 * Every block but the last one is a whole number of 3-byte blocks, so its encoding starts at
+	 * 4/3 of its offset, past its own start, and never reaches into the blocks before it.
 	 */
-	uint nChunks = inSize / 4;
+	byte staged[_inPlaceBlockSize];
+	byte * data = reinterpret_cast<byte *>(buffer.data());
+	char * out = reinterpret_cast<char *>(buffer.data());
+	ulong nBlocks = (inSize + _inPlaceBlockSize - 1) / _inPlaceBlockSize;
+	
+	for(ulong block = nBlocks; block > 0; block--)
+	{
+		ulong offset = (block - 1) * _inPlaceBlockSize;
+		ulong size = inSize - offset < _inPlaceBlockSize ? inSize - offset : _inPlaceBlockSize;
+		
+		memcpy(staged, data + offset, size);
+		encodeBuffer(staged, out + offset / 3 * 4, size);
+	}
+	
+	return stats.finish(getEncodedSize(inSize));
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeInPlace(std::span<char> buffer)
+{
+	ulong inSize = buffer.size();
+	StatsScope stats(DECODE_BUFFER, inSize);
+	
+	if(!isValidLength(inSize))
+		throw decodeError(stats.finish(DecodeResult { INVALID_LENGTH, inSize, 0 }), NULL);
+	
 	/**
-	 * The length in bytes of the resulting decoded data.
+	 * The decoding of a block starts at 3/4 of its offset, so it can only overwrite the block
+	 * itself, which was copied aside, and the decodings of the blocks before it stay in place.
 	 */
-	ulong decodedLength = 0;
+	const ulong stagedCapacity = _inPlaceBlockSize / 3 * 4;
+	char staged[stagedCapacity];
+	byte * out = reinterpret_cast<byte *>(buffer.data());
+	ulong outLength = 0;
+	
+	for(ulong done = 0; done < inSize; )
+	{
+		ulong size = inSize - done < stagedCapacity ? inSize - done : stagedCapacity;
+		memcpy(staged, buffer.data() + done, size);
+		
+		ulong decodedLength;
+		ulong errorOffset = decodeFused(staged, out + outLength, size, decodedLength);
+		
+		/**
+		 * What looks like padding at the end of a block is in the middle of the input.
+		 */
+		if(errorOffset == size && done + size < inSize && Alphabet::padding && staged[size - 1] == _paddingChar)
+			errorOffset = staged[size - 2] == _paddingChar ? size - 2 : size - 1;
+		
+		if(errorOffset != size)
+		{
+			stats.finish(DecodeResult { INVALID_CHARACTER, done + errorOffset, 0 });
+			throw invalidCharError(staged[errorOffset], done + errorOffset);
+		}
+		
+		outLength += decodedLength;
+		done += size;
+	}
+	
+	return stats.finish(outLength);
+}
+
+/**
+ * Tells whether the character is a space or one of '\t', '\n', '\v', '\f' and '\r'.
+ */
+static inline bool isWhitespace(char ch)
+{
+	return ch == ' ' || static_cast<byte>(ch - '\t') <= '\r' - '\t';
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::compactWhitespace(const char * in, char * out, ulong inSize)
+{
+	CompactKernel compact = kernels().compact;
+	ulong outLength = 0;
+	ulong done = 0;
+	
+	if(compact != NULL)
+		done = compact(in, out, inSize, outLength);
 	
 	/**
-	 * Get pointers to the input and output buffer.
+	 * Every character is stored, but the output only moves past the ones that are not
+	 * whitespace, so there is no branch to mispredict on whitespace-heavy input.
 	 */
-	const char * inPtr = in;
-	byte * outPtr = out;
+	for(; done < inSize; done++)
+	{
+		out[outLength] = in[done];
+		outLength += !isWhitespace(in[done]);
+	}
+	
+	return outLength;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeBufferLenient(const char * in, byte * out, ulong inSize)
+{
+	StatsScope stats(DECODE_BUFFER, inSize);
 	
 	/**
-	 * Decode each chunk, advance the pointers and keep track of
-	 * the length of the decoded data.
+	 * The compacted characters are staged here, with room for the kernel's overlong stores.
 	 */
-	for(uint i = 0; i < nChunks; i++)
+	char staged[_lenientBlockSize + 16];
+	ulong stagedSize = 0;
+	ulong stagedBase = 0;
+	ulong done = 0;
+	ulong outLength = 0;
+	
+	for(;;)
 	{
-		decodedLength += decodeBlock(inPtr, outPtr);
-		inPtr += 4;
-		outPtr += 3;
+		ulong size = inSize - done < _lenientBlockSize - stagedSize ? inSize - done : _lenientBlockSize - stagedSize;
+		stagedSize += compactWhitespace(in + done, staged + stagedSize, size);
+		done += size;
+		
+		bool last = done == inSize;
+		
+		/**
+		 * Unless the input is over, hold back the last complete block, which could be the
+		 * padded one, and whatever follows it. They are decoded in the next round.
+		 */
+		ulong decodeSize = stagedSize;
+		if(!last)
+			decodeSize = stagedSize >= 4 ? stagedSize / 4 * 4 - 4 : 0;
+		
+		if(last && !isValidLength(stagedBase + stagedSize))
+		{
+			stats.finish(DecodeResult { INVALID_LENGTH, stagedBase + stagedSize, 0 });
+			throw invalidLengthError("base64-encoded data without whitespace", stagedBase + stagedSize);
+		}
+		
+		ulong decodedLength;
+		ulong errorOffset = decodeFused(staged, out + outLength, decodeSize, decodedLength);
+		
+		/**
+		 * A padded block followed by more data is reported as an invalid padding character.
+		 */
+		if(errorOffset == decodeSize && !last && decodedLength != decodeSize / 4 * 3)
+			errorOffset = staged[decodeSize - 2] == _paddingChar ? decodeSize - 2 : decodeSize - 1;
+		
+		if(errorOffset != decodeSize)
+		{
+			/**
+			 * Map the offset in the compacted data back to the offset in the input.
+			 */
+			ulong target = stagedBase + errorOffset;
+			ulong i = 0;
+			for(ulong seen = 0; isWhitespace(in[i]) || seen++ < target; i++)
+				;
+			
+			stats.finish(DecodeResult { INVALID_CHARACTER, i, 0 });
+			throw invalidCharError(in[i], i);
+		}
+		
+		outLength += decodedLength;
+		if(last)
+			return stats.finish(outLength);
+		
+		memmove(staged, staged + decodeSize, stagedSize - decodeSize);
+		stagedSize -= decodeSize;
+		stagedBase += decodeSize;
+	}
+}
+
+template <class Alphabet>
+std::runtime_error BasicBase64<Alphabet>::invalidCharError(char ch, ulong offset)
+{
+	std::ostringstream error;
+	error << "The input string is not a valid base64 encoding: invalid character '" << ch
+		<< "' (ASCII code: " << static_cast<unsigned short>(static_cast<byte>(ch))
+		<< ") at offset " << offset << ".";
+	return std::runtime_error(error.str());
+}
+
+template <class Alphabet>
+std::runtime_error BasicBase64<Alphabet>::invalidLengthError(const char * what, ulong length)
+{
+	std::ostringstream error;
+	error << "The length of the " << what << " (" << length << ")";
+	if(Alphabet::padding)
+		error << " is not a multiple of 4.";
+	else
+		error << " leaves a single character in its last block.";
+	return std::runtime_error(error.str());
+}
+
+template <class Alphabet>
+std::runtime_error BasicBase64<Alphabet>::decodeError(const DecodeResult & result, const char * in)
+{
+	if(result.error == INVALID_CHARACTER)
+		return invalidCharError(in[result.offset], result.offset);
+
+	if(result.error == INVALID_LENGTH)
+		return invalidLengthError("base64-encoded line", result.offset);
+
+	std::ostringstream error;
+	error << "The output buffer is too small for the decoded data (" << result.length << " bytes).";
+	return std::runtime_error(error.str());
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeLines(const byte * in, char * out, ulong inSize, const char * newline, uint lineSize)
+{
+	ulong inLineSize = lineSize / 4 * 3;
+	ulong newlineSize = strlen(newline);
+	char * outPtr = out;
+	
+	/**
+	 * Encode the input a line at a time, following each line by the newline,
+	 * including the last one, which might be shorter than the others.
+	 */
+	for(ulong done = 0; done < inSize; done += inLineSize)
+	{
+		ulong size = inSize - done < inLineSize ? inSize - done : inLineSize;
+		
+		outPtr += encodeBuffer(in + done, outPtr, size);
+		memcpy(outPtr, newline, newlineSize);
+		outPtr += newlineSize;
 	}
 	
-	return decodedLength;
+	return outPtr - out;
 }
 
-void Base64::encodeFile(const char * inFile, const char * outFile, const char * newline, uint lineSize) throw (std::runtime_error)
+template <class Alphabet>
+void BasicBase64<Alphabet>::encodeFile(const char * inFile, const char * outFile, const char * newline, uint lineSize,
+	uint nThreads)
 {
+	/**
+	 * Threads need to write their parts of the output file independently of each other,
+	 * which is what the mapped version does.
+	 */
+	if(nThreads > 1)
+	{
+		encodeFileMapped(inFile, outFile, newline, lineSize, nThreads);
+		return;
+	}
+	
+	StatsScope stats(ENCODE_FILE);
+	
 	/**
 	 * The line size in the out file must be a multiple of 4 (It's simply how base64 works)
 	 */
-	if(lineSize % 4)
+	if(lineSize % 4 || lineSize == 0)
 	{
-		std::ostringstream error("The output file line size must be a multiple of 4. You provided ");
-		error << lineSize << ".";
+		std::ostringstream error;
+		error << "The output file line size must be a positive multiple of 4. You provided " << lineSize << ".";
 		throw std::runtime_error(error.str());
 	}
 	
@@ -319,6 +762,9 @@ void Base64::encodeFile(const char * inFile, const char * outFile, const char *
 		throw std::runtime_error(error.str());
 	}
 	
+	stats.setBytesIn(fileLength);
+	stats.setBytesOut(getEncodedFileSize(fileLength, newline, lineSize));
+	
 	/**
 	 * Open the destination file, where the base64 encoding will be stored.
 	 * Do some error checking.
@@ -333,50 +779,44 @@ void Base64::encodeFile(const char * inFile, const char * outFile, const char *
 	}
 	
 	/**
-	 * Split the input file into chunks. Each chunk is going to be encoded
-	 * into a line. The last line might not have the same size as the others
-	 * so it needs to be handled separately.
+	 * Read the input file in large blocks, made of a whole number of lines' worth of
+	 * input, and encode each block straight into an output block that already has the
+	 * newlines in it. The last block might be shorter than the others and end in a
+	 * partial line.
 	 */
-	uint outBufferSize = lineSize, inBufferSize = lineSize * 3 / 4;
-	uint nChunks = fileLength / inBufferSize;
-	uint lastChunkSize = fileLength % inBufferSize;
+	ulong inLineSize = lineSize / 4 * 3;
+	ulong linesPerBlock = _fileBlockSize / inLineSize > 0 ? _fileBlockSize / inLineSize : 1;
+	ulong inBufferSize = linesPerBlock * inLineSize;
+	ulong outBufferSize = linesPerBlock * (lineSize + strlen(newline));
 	
 	/**
-	 * Allocate temporary buffers for reading a chunk into and for
-	 * storing the encoded chunk into.
+	 * Allocate temporary buffers for reading a block into and for
+	 * storing the encoded block into.
 	 */
 	byte * inBuffer = new byte[inBufferSize];
-	char * outBuffer = new char[outBufferSize + 1];
-	outBuffer[outBufferSize] = '\0';
+	char * outBuffer = new char[outBufferSize];
 	
 	try 
 	{
-		/**
-		 * Encode the input file by reading a chunk, encoding it
-		 * in base64 and storing it as a line in the output file.
-		 */
-		for(uint i = 0; i < nChunks; i++)
-		{	
-			fin.read(reinterpret_cast<char *>(inBuffer), inBufferSize);
-			
-			encodeBuffer(inBuffer, outBuffer, inBufferSize);
-			
-			fout << outBuffer << newline;
-		}
-		
-		/**
-		 * Handle the last chunk, if existent.
-		 */
-		if(lastChunkSize)
+		for(ulong done = 0; done < fileLength; done += inBufferSize)
 		{
-			memset(inBuffer, 0, inBufferSize);
-			memset(outBuffer, 0, outBufferSize);
+			ulong blockSize = fileLength - done < inBufferSize ? fileLength - done : inBufferSize;
 			
-			fin.read(reinterpret_cast<char *>(inBuffer), lastChunkSize);		
+			if(!fin.read(reinterpret_cast<char *>(inBuffer), blockSize))
+			{
+				std::ostringstream error;
+				error << "Cannot read from input file: " << inFile;
+				throw std::runtime_error(error.str());
+			}
 			
-			encodeBuffer(inBuffer, outBuffer, lastChunkSize);
+			ulong outLength = encodeLines(inBuffer, outBuffer, blockSize, newline, lineSize);
 			
-			fout << outBuffer << newline;
+			if(!fout.write(outBuffer, outLength))
+			{
+				std::ostringstream error;
+				error << "Cannot write to output file: " << outFile;
+				throw std::runtime_error(error.str());
+			}
 		}
 	}
 	catch(...)
@@ -397,8 +837,21 @@ void Base64::encodeFile(const char * inFile, const char * outFile, const char *
 	fout.close();
 }
 
-void Base64::decodeFile(const char * inFile, const char * outFile) throw (std::runtime_error)
+template <class Alphabet>
+void BasicBase64<Alphabet>::decodeFile(const char * inFile, const char * outFile, uint nThreads)
 {
+	/**
+	 * Threads need to read and write their parts of the files independently
+	 * of each other, which is what the mapped version does.
+	 */
+	if(nThreads > 1)
+	{
+		decodeFileMapped(inFile, outFile, nThreads);
+		return;
+	}
+	
+	StatsScope stats(DECODE_FILE);
+	
 	/**
 	 * Open the input file to be decoded and check for errors.
 	 */
@@ -426,6 +879,8 @@ void Base64::decodeFile(const char * inFile, const char * outFile) throw (std::r
 		throw std::runtime_error(error.str());
 	}
 	
+	stats.setBytesIn(fileLength);
+	
 	/**
 	 * Open the ouput file file to store the decoded file in.
 	 * Check for errors.
@@ -441,99 +896,139 @@ void Base64::decodeFile(const char * inFile, const char * outFile) throw (std::r
 	}
 	
 	/**
-	 * Start decoding the file, line by line.
+	 * Read the file in large blocks and feed its lines to the decoder without the newlines, so
+	 * that lines can be of any size, span several blocks and split the 4-character blocks of
+	 * the encoding anywhere. A line that ends in padding completes its encoding, so the decoder
+	 * is finished (and reset) after it, as well as at the end of the file. The padding can be
+	 * split across lines too, so the block it ends has to be complete first.
 	 */
-	uint lineSize = 76;
-	ulong lineCount = 0;
-	uint outBufferSize = getDecodedSize(lineSize);
-	byte * outBuffer = new byte[outBufferSize];
-	std::string inBuffer;
+	ulong inBufferSize = _fileBlockSize;
+	char * inBuffer = new char[inBufferSize];
+	byte * outBuffer = new byte[Decoder::getMaxUpdateSize(inBufferSize) + 3];
 	
-	do {
-		try
+	Decoder decoder;
+	ulong lineCount = 1;
+	ulong lastDataLine = 1;
+	ulong decodedLength = 0;
+	bool pendingCR = false;
+	char lineLast = 0;
+	
+	try
+	{
+		for(ulong done = 0; done < fileLength; done += inBufferSize)
 		{
-			/**
-			 * Read in a line.
-			 */
-			getline(fin, inBuffer);
-			lineCount++;
+			ulong blockSize = fileLength - done < inBufferSize ? fileLength - done : inBufferSize;
 			
-			/**
-			 * Check if the line is \r\n terminated, and strip the \r away if it is.
-			 * TODO: Actually trim the line.
-			 */
-			if(inBuffer.length() > 0 && inBuffer[inBuffer.length()-1] == '\r')
+			if(!fin.read(inBuffer, blockSize))
 			{
-				inBuffer.erase(inBuffer.length()-1);
+				std::ostringstream error;
+				error << "Cannot read from input file: " << inFile;
+				throw std::runtime_error(error.str());
 			}
 			
-			/**
-			 * Get the line's size and skip empty lines.
-			 * TODO: Decide how to properly handle empty lines.
-			 */
-			lineSize = inBuffer.length();
-			if(lineSize == 0)
-				continue;
+			const char * inPtr = inBuffer;
+			const char * inEnd = inBuffer + blockSize;
+			byte * outPtr = outBuffer;
 			
-			/**
-			 * The line size must be a multiple of 4 (otherwise the file is not a correctly encoded one).
-			 */
-			if(lineSize % 4)
+			try
 			{
-				fin.close();
-				fout.close();
-				delete [] outBuffer;
+				/**
+				 * A \r at the end of the previous block is only part of the
+				 * newline if this block starts with a \n.
+				 */
+				if(pendingCR && *inPtr != '\n')
+				{
+					outPtr += decoder.update("\r", outPtr, 1);
+					lineLast = '\r';
+				}
+				pendingCR = false;
+				
+				while(inPtr < inEnd)
+				{
+					const char * lineEnd = static_cast<const char *>(memchr(inPtr, '\n', inEnd - inPtr));
+					ulong size = (lineEnd != NULL ? lineEnd : inEnd) - inPtr;
+					
+					/**
+					 * Strip the \r away from \r\n terminated lines, including
+					 * the ones whose \n is in the next block.
+					 */
+					if(size > 0 && inPtr[size - 1] == '\r')
+					{
+						size--;
+						pendingCR = lineEnd == NULL;
+					}
+					
+					if(size > 0)
+					{
+						outPtr += decoder.update(inPtr, outPtr, size);
+						lineLast = inPtr[size - 1];
+						lastDataLine = lineCount;
+					}
+					
+					if(lineEnd == NULL)
+						break;
+					
+					if(Alphabet::padding && lineLast == _paddingChar && decoder.atBlockBoundary())
+						outPtr += decoder.finish(outPtr);
+					lineLast = 0;
+					lineCount++;
+					inPtr = lineEnd + 1;
+				}
 				
+				/**
+				 * The last line doesn't need a newline, and a truncated encoding
+				 * is blamed on the last line that had any data.
+				 */
+				if(done + blockSize == fileLength)
+				{
+					lineCount = lastDataLine;
+					outPtr += decoder.finish(outPtr);
+				}
+			}
+			catch(std::runtime_error & e)
+			{
 				std::ostringstream error;
-				error << "Line #" << lineCount << " needs to have the size divisible by 4 in output file \""
-					<< outFile << "\"";
+				error << "Line #" << lineCount << " in input file \"" << inFile << "\": " << e.what();
 				throw std::runtime_error(error.str());
 			}
 			
-			/**
-			 * If the next line happens to be bigger than the previous line then we need to
-			 * reallocate a bigger output buffer. This is just an error tolerance measure.
-			 */
-			if(lineSize * 3 / 4 > outBufferSize)
+			if(!fout.write(reinterpret_cast<char *>(outBuffer), outPtr - outBuffer))
 			{
-				delete [] outBuffer;
-				outBuffer = new byte[lineSize * 3 / 4];
+				std::ostringstream error;
+				error << "Cannot write to output file: " << outFile;
+				throw std::runtime_error(error.str());
 			}
 			
-			/**
-			 * Calculate the new buffer size, which might have changed if the current
-			 * line size is different than the previous one.
-			 */
-			outBufferSize = lineSize * 3 / 4;
-			
-			/**
-			 * Check for padding characters at the end of the line.
-			 */
-			uint numEqualSigns = 0;
-			if(inBuffer[lineSize-1] == _paddingChar) numEqualSigns++;
-			if(inBuffer[lineSize-2] == _paddingChar) numEqualSigns++;
-			
-			/**
-			 * Decode the line and write the resulting block of data out.
-			 */
-			ulong decodedLength = Base64::decodeBuffer(inBuffer.c_str(), outBuffer, lineSize);
-			
-			fout.write(reinterpret_cast<char *>(outBuffer), decodedLength);
-		}
-		catch(...) 
-		{
-			fin.close();
-			fout.close();
-			delete [] outBuffer;
-			throw;
+			decodedLength += outPtr - outBuffer;
 		}
-	} while(!fin.eof());
+	}
+	catch(...)
+	{
+		delete [] inBuffer;
+		delete [] outBuffer;
+		
+		fin.close();
+		fout.close();
+		
+		throw;
+	}
+	
+	stats.setBytesOut(decodedLength);
 	
 	/**
 	 * Cleanup.
 	 */
+	delete [] inBuffer;
 	delete [] outBuffer;
 	
 	fin.close();
 	fout.close();
 }
+
+/**
+ * Compile the codecs for every alphabet. The kernels are instantiated along with
+ * the rest of their instruction set's file.
+ */
+template class BasicBase64<StandardAlphabet>;
+template class BasicBase64<UrlAlphabet>;
+template class BasicBase64<UrlUnpaddedAlphabet>;
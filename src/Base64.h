@@ -9,24 +9,479 @@
 
 #include "Core.h"
 
+#include <array>
+#include <atomic>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/uio.h>
+
+/**
+ * The alphabet and padding policies the base64 codecs are specialized on. Each one gives the
+ * characters for 62 and 63, which come after the letters and the digits, and whether encodings
+ * are padded with '=' up to a multiple of 4 characters. Both characters must be ASCII.
+ */
+struct StandardAlphabet
+{
+	static const char char62 = '+';
+	static const char char63 = '/';
+	static const bool padding = true;
+};
+
+/**
+ * The URL and filename safe alphabet of RFC 4648, as used in URLs and JWTs.
+ */
+struct UrlAlphabet
+{
+	static const char char62 = '-';
+	static const char char63 = '_';
+	static const bool padding = true;
+};
+
+struct UrlUnpaddedAlphabet
+{
+	static const char char62 = '-';
+	static const char char63 = '_';
+	static const bool padding = false;
+};
+
+/**
+ * The lookup tables of an alphabet, computed at compile time.
+ */
+template <class Alphabet>
+struct Base64Tables
+{
+	/**
+	 * Maps every 6-bit number to its character in the alphabet.
+	 */
+	char byteToChar[64];
+	
+	/**
+	 * Maps every character back to its 6-bit number, or to 0xFF if it's not in the alphabet.
+	 */
+	byte charToByte[256];
+	
+	/**
+	 * The nibble tables of the AVX2 decoding kernel. A character is in the alphabet only if the
+	 * flags of its low nibble and of its high nibble have no bit in common. High nibbles with the
+	 * same valid low nibbles share a flag, and bit 0 flags the high nibbles without any. Adding
+	 * the offset of its high nibble turns a character into its 6-bit number, except for the
+	 * characters of 62 and 63, which have their own entries, char62Slot and char63Slot.
+	 */
+	byte loNibbleFlags[16];
+	byte hiNibbleFlags[16];
+	signed char nibbleOffsets[16];
+	uint nibbleClasses;
+	
+	static const uint char62Slot = 14;
+	static const uint char63Slot = 15;
+	
+	constexpr Base64Tables()
+		: byteToChar(), charToByte(), loNibbleFlags(), hiNibbleFlags(), nibbleOffsets(), nibbleClasses(0)
+	{
+		for(uint i = 0; i < 26; i++)
+		{
+			byteToChar[i] = 'A' + i;
+			byteToChar[26 + i] = 'a' + i;
+		}
+		
+		for(uint i = 0; i < 10; i++)
+			byteToChar[52 + i] = '0' + i;
+		
+		byteToChar[62] = Alphabet::char62;
+		byteToChar[63] = Alphabet::char63;
+		
+		for(uint ch = 0; ch < 256; ch++)
+			charToByte[ch] = 0xFF;
+		
+		for(uint i = 0; i < 64; i++)
+			charToByte[static_cast<byte>(byteToChar[i])] = i;
+		
+		/**
+		 * Group the high nibbles by their valid low nibbles. There is only room for 7 groups
+		 * in a byte of flags, past which the classes array overflows, which does not compile.
+		 */
+		uint validLo[16] = {};
+		uint classes[7] = {};
+		
+		for(uint i = 0; i < 64; i++)
+			validLo[static_cast<byte>(byteToChar[i]) >> 4] |= 1 << (byteToChar[i] & 0x0F);
+		
+		for(uint hi = 0; hi < 16; hi++)
+		{
+			if(validLo[hi] == 0)
+			{
+				hiNibbleFlags[hi] = 0x01;
+				continue;
+			}
+			
+			uint k = 0;
+			while(k < nibbleClasses && classes[k] != validLo[hi])
+				k++;
+			if(k == nibbleClasses)
+				classes[nibbleClasses++] = validLo[hi];
+			
+			hiNibbleFlags[hi] = 0x02 << k;
+		}
+		
+		for(uint lo = 0; lo < 16; lo++)
+		{
+			loNibbleFlags[lo] = 0x01;
+			for(uint k = 0; k < nibbleClasses; k++)
+			{
+				if(!(classes[k] & (1 << lo)))
+					loNibbleFlags[lo] |= 0x02 << k;
+			}
+		}
+		
+		for(uint i = 0; i < 62; i++)
+			nibbleOffsets[byteToChar[i] >> 4] = i - byteToChar[i];
+		
+		nibbleOffsets[char62Slot] = 62 - Alphabet::char62;
+		nibbleOffsets[char63Slot] = 63 - Alphabet::char63;
+	}
+};
+
+/**
+ * A string literal passed as a template argument, to be decoded at compile time.
+ */
+template <ulong N>
+struct Base64Literal
+{
+	static const ulong size = N - 1;
+	char chars[N];
+	
+	consteval Base64Literal(const char (&literal)[N]) : chars()
+	{
+		for(ulong i = 0; i < N; i++)
+			chars[i] = literal[i];
+	}
+};
+
+/**
+ * The parts of the base64 codecs that don't depend on the alphabet: picking the backend
+ * the encoding and decoding methods run on, and compacting whitespace away.
+ */
+class Base64Common
+{
+	public:
+		/**
+		 * The implementations the encoding and decoding methods can run on, from the slowest
+		 * to the fastest. Each one but SCALAR and SWAR needs the CPU to support its instruction set.
+		 */
+		enum Backend
+		{
+			SCALAR,
+			SWAR,
+			SSSE3,
+			AVX2,
+			AVX512,
+			NUM_BACKENDS
+		};
+
+		/**
+		 * The kinds of errors the non-throwing decoding methods report.
+		 */
+		enum DecodeError
+		{
+			DECODE_OK,
+			INVALID_LENGTH,
+			INVALID_CHARACTER,
+			OUTPUT_TOO_SMALL,
+			NUM_DECODE_ERRORS
+		};
+
+		/**
+		 * What a non-throwing decoding method did. Reporting an error this way costs next to
+		 * nothing, so rejecting garbage input is about as fast as decoding valid input.
+		 */
+		struct DecodeResult
+		{
+			DecodeError error;
+
+			/**
+			 * The offset in the input of the first invalid character, or the length of the input if
+			 * the length is invalid. 0 otherwise.
+			 */
+			ulong offset;
+
+			/**
+			 * The number of bytes stored in the output buffer, or the number of bytes the output
+			 * buffer needs if it's too small. 0 otherwise.
+			 */
+			ulong length;
+		};
+
+		/**
+		 * Returns the backend the encoding and decoding methods run on. The first call picks the
+		 * fastest backend supported by the CPU, unless the BASE64_BACKEND environment variable names
+		 * another supported backend (see getBackendName), in which case that one is picked.
+		 * Every alphabet runs on the same backend.
+		 *
+		 * @return	the backend currently in use
+		 */
+		static Backend getBackend();
+
+		/**
+		 * Makes the encoding and decoding methods run on the specified backend from now on.
+		 * This is not meant to be called while other threads are encoding or decoding.
+		 *
+		 * @param	backend	the backend to use
+		 *
+		 * @throws	std::runtime_error
+		 *				if the CPU does not support the backend's instruction set
+		 */
+		static void setBackend(Backend backend);
+
+		/**
+		 * @return	true if the CPU supports the instruction set of the specified backend
+		 */
+		static bool isBackendSupported(Backend backend);
+
+		/**
+		 * @return	the fastest backend supported by the CPU
+		 */
+		static Backend getBestBackend();
+
+		/**
+		 * Returns the name of the specified backend, which is also what the BASE64_BACKEND
+		 * environment variable should be set to in order to select it: "scalar", "swar",
+		 * "ssse3", "avx2" or "avx512".
+		 *
+		 * @return	the name of the backend
+		 */
+		static const char * getBackendName(Backend backend);
+
+		/**
+		 * The entry points the statistics are kept for. DECODE_BUFFER counts decodeBuffer, decode,
+		 * decodeInto, decodeFragments, decodeInPlace, decodeBufferLenient, decodeBatch and the
+		 * non-throwing versions, ENCODE_BUFFER the encoding methods that match them, and
+		 * VALIDATE_ENCODING both validation methods. The file and batch methods count as a single
+		 * call each, not as the buffer calls they make.
+		 */
+		enum Operation
+		{
+			ENCODE_BUFFER,
+			DECODE_BUFFER,
+			VALIDATE_ENCODING,
+			ENCODE_FILE,
+			DECODE_FILE,
+			NUM_OPERATIONS
+		};
+
+		/**
+		 * Latency bucket i counts the calls that took less than 2^i nanoseconds, but not less than
+		 * 2^(i - 1). The last bucket also counts all the slower calls, from about 4.5 minutes on.
+		 */
+		static const uint NUM_LATENCY_BUCKETS = 40;
+
+		/**
+		 * The statistics of one operation, summed over every thread.
+		 */
+		struct OperationStats
+		{
+			ulong calls;
+
+			/**
+			 * The number of calls that threw an exception other than a decoding error,
+			 * e.g. because a file could not be opened.
+			 */
+			ulong failures;
+
+			/**
+			 * The number of calls to the buffer methods that ran into each kind of decoding
+			 * error, whether they returned it or threw it. The DECODE_OK entry stays at 0.
+			 */
+			ulong errors[NUM_DECODE_ERRORS];
+
+			/**
+			 * The sizes of the inputs and of the outputs of the calls that succeeded.
+			 */
+			ulong bytesIn;
+			ulong bytesOut;
+
+			ulong latency[NUM_LATENCY_BUCKETS];
+		};
+
+		struct Stats
+		{
+			/**
+			 * The backend in use when the statistics were read.
+			 */
+			Backend backend;
+
+			OperationStats operations[NUM_OPERATIONS];
+		};
+
+		/**
+		 * Starts or stops keeping statistics of the calls to the encoding, decoding and validation
+		 * methods. They're off by default. While they're on, each call takes two more reads of the
+		 * clock and updates counters of the calling thread, which no other thread writes to.
+		 */
+		static void setStatsEnabled(bool enabled);
+		static bool isStatsEnabled();
+
+		/**
+		 * Returns the statistics kept since the last call to resetStats, summed over every thread,
+		 * including the threads that have exited since. Counters being updated by other threads
+		 * while they're read may be off by the calls in progress.
+		 *
+		 * @return	the statistics of every operation
+		 */
+		static Stats getStats();
+
+		/**
+		 * Starts the statistics over from 0.
+		 */
+		static void resetStats();
+
+		/**
+		 * Returns the name of the specified operation, which is the name of the method it counts:
+		 * "encodeBuffer", "decodeBuffer", "isValidEncoding", "encodeFile" or "decodeFile".
+		 *
+		 * @return	the name of the operation
+		 */
+		static const char * getOperationName(Operation operation);
+
+	protected:
+		/**
+		 * Records one call to an entry point in the statistics of the calling thread, from its
+		 * construction to its destruction, if the statistics are on. A call made while another
+		 * one is being recorded on the same thread is part of that one and isn't recorded. A scope
+		 * for NUM_OPERATIONS records nothing, but keeps the calls it's around from being recorded,
+		 * e.g. those the worker threads of the file methods make.
+		 */
+		class StatsScope
+		{
+			public:
+				StatsScope(Operation operation, ulong bytesIn = 0)
+					: _operation(operation), _bytesIn(bytesIn), _bytesOut(0), _error(DECODE_OK), _counted(false),
+					_recording(false), _start(0), _exceptions(0)
+				{
+					if(_statsEnabled.load(std::memory_order_relaxed))
+						start();
+				}
+				
+				~StatsScope()
+				{
+					if(_counted)
+						stop();
+				}
+				
+				void setBytesIn(ulong bytesIn) { _bytesIn = bytesIn; }
+				void setBytesOut(ulong bytesOut) { _bytesOut = bytesOut; }
+				
+				/**
+				 * Records the output size or the error of the call and returns what it's passed,
+				 * for the return statements of the methods.
+				 */
+				ulong finish(ulong bytesOut)
+				{
+					_bytesOut = bytesOut;
+					return bytesOut;
+				}
+				
+				DecodeResult finish(const DecodeResult & result)
+				{
+					_error = result.error;
+					_bytesOut = result.length;
+					return result;
+				}
+				
+			private:
+				void start() noexcept;
+				void stop() noexcept;
+				
+				Operation _operation;
+				ulong _bytesIn;
+				ulong _bytesOut;
+				DecodeError _error;
+				bool _counted;
+				bool _recording;
+				ulong _start;
+				int _exceptions;
+		};
+
+		/**
+		 * Vectorized whitespace compaction kernel, defined in Base64Ssse3.cpp. It copies 16 characters
+		 * at a time to the output buffer, skipping the whitespace among them by left-packing the rest
+		 * with pshufb. The output buffer needs 16 bytes of slack past the compacted characters.
+		 *
+		 * @param	in			the input buffer to compact
+		 * @param	out			the output buffer where the characters that are not whitespace will be stored
+		 * @param	inSize		the length in bytes of the input buffer
+		 * @param	outLength	set to the number of characters stored in the output buffer
+		 *
+		 * @return	the number of input characters that were compacted, always a multiple of 16
+		 */
+		static ulong compactSsse3(const char * in, char * out, ulong inSize, ulong & outLength);
+
+		/**
+		 * The lookup table of the compaction kernel, built on first use.
+		 */
+		struct LeftPackTable;
+		static const LeftPackTable & leftPackTable();
+
+	private:
+		/**
+		 * The names of the backends, indexed by Backend.
+		 */
+		static const char * const _backendNames[NUM_BACKENDS];
+		
+		/**
+		 * The names of the operations, indexed by Operation.
+		 */
+		static const char * const _operationNames[NUM_OPERATIONS];
+		
+		/**
+		 * Whether the statistics are on, read by every StatsScope.
+		 */
+		static std::atomic<bool> _statsEnabled;
+};
 
 /**
- * The Base64 class provides static methods for encoding
- * and decode memory blocks or files using the base64 algorithm.
+ * The BasicBase64 class provides static methods for encoding
+ * and decode memory blocks or files using the base64 algorithm,
+ * with the alphabet and padding of its Alphabet policy. The tables
+ * of every alphabet are computed at compile time and every kernel
+ * is compiled for each alphabet, so they all run at the same speed.
  *
  * @author		Alin Tomescu
  * @version		0.2
  * @date		12/22/2011
  */
-class Base64
+template <class Alphabet>
+class BasicBase64 : public Base64Common
 {
 	public:
 		/**
-		 *	TODO: Add a calculateBufferSize method for encoding and decoding.
+		 * Return the size of the output buffer needed to encode or decode a buffer of the specified
+		 * size. getDecodedSize can be up to 2 bytes over, since it doesn't look at the padding.
+		 */
+		static constexpr ulong getEncodedSize(ulong inputBufferSize)
+		{
+			if(Alphabet::padding)
+				return (inputBufferSize / 3) * 4 + (inputBufferSize % 3 > 0 ? 4 : 0);
+			else
+				return (inputBufferSize / 3) * 4 + (inputBufferSize % 3 > 0 ? inputBufferSize % 3 + 1 : 0);
+		}
+		static constexpr ulong getDecodedSize(ulong inputBufferSize) { return (inputBufferSize / 4) * 3 + (inputBufferSize % 4 > 1 ? inputBufferSize % 4 - 1 : 0); }
+		
+		/**
+		 * Returns the exact size of the data the specified base64 encoding decodes to, which
+		 * unlike getDecodedSize(ulong) takes the padding at its end into account.
 		 */
-		static ulong getEncodedSize(ulong inputBufferSize) { return (inputBufferSize / 3) * 4 + (inputBufferSize % 3 > 0 ? 4 : 0); }
-		static ulong getDecodedSize(ulong inputBufferSize) { return (inputBufferSize / 4) * 3; }
+		static constexpr ulong getDecodedSize(const char * in, ulong inSize)
+		{
+			ulong nPadding = 0;
+			if(Alphabet::padding && inSize >= 4 && inSize % 4 == 0 && in[inSize - 1] == _paddingChar)
+				nPadding = in[inSize - 2] == _paddingChar ? 2 : 1;
+			
+			return getDecodedSize(inSize) - nPadding;
+		}
 		
 		/**
 		 *	Returns true if the bytes in the specified buffer represent a valid base64-encoding.
@@ -35,6 +490,18 @@ class Base64
 		 */
 		static bool isValidEncoding(const char * buffer, ulong length);
 		
+		/**
+		 * Checks that the specified buffer is a valid base64 encoding without decoding it, with the
+		 * vectorized validation kernels of the backend in use, at close to memory bandwidth. Errors
+		 * are reported just like tryDecodeBuffer reports them, at the same offsets.
+		 *
+		 * @param	in		the base64-encoded string to check
+		 * @param	inSize	the length in bytes of the string
+		 *
+		 * @return	the length in bytes of the data the string decodes to, or the error and where it is
+		 */
+		static DecodeResult validateEncoding(const char * in, ulong inSize) noexcept;
+		
 		/**
 		 * TODO: Should this null-terminate the string? Maybe it should...
 		 * Encodes the specified input buffer in base64 and stores it in the output buffer.
@@ -59,7 +526,295 @@ class Base64
 		 * @throws	std::runtime_error
 		 *				if the input string is not a valid base64-encoded string
 		 */
-		static ulong decodeBuffer(const char * in, byte * out, ulong inSize) throw (std::runtime_error);
+		static ulong decodeBuffer(const char * in, byte * out, ulong inSize);
+
+		/**
+		 * Decodes a base64-encoded string just like decodeBuffer, but reports errors in the
+		 * returned result instead of throwing, e.g. to reject untrusted input cheaply.
+		 *
+		 * @param	in	the input base64-encoded string to decode
+		 * @param	out	the output buffer where the decoded string will be stored
+		 * @param	inSize	the length in bytes of the input buffer
+		 *
+		 * @return	the length in bytes of the decoded data, or the error and where it is
+		 */
+		static DecodeResult tryDecodeBuffer(const char * in, byte * out, ulong inSize) noexcept;
+
+		/**
+		 * Encodes the specified input buffer in base64 on several threads, e.g. to encode large
+		 * blobs in memory faster than a single core can. The input is split into chunks of a
+		 * multiple of 3 bytes, so each chunk's encoding starts at a known offset, which the threads
+		 * of the ThreadPool encode straight into the output buffer. Inputs too small to be worth
+		 * splitting (under _parallelMinSize bytes) are encoded on the calling thread.
+		 *
+		 * @param	in			the input buffer to encode
+		 * @param	out			the output buffer where the base64-encoded string will be stored
+		 * @param	inSize		the length in bytes of the input buffer
+		 * @param	nThreads	the maximum number of threads to encode on, the calling thread included
+		 *
+		 * @return	the length in bytes of the encoded data in the output buffer
+		 */
+		static ulong encodeBuffer(const byte * in, char * out, ulong inSize, uint nThreads);
+
+		/**
+		 * Decodes a base64-encoded string on several threads, just like the parallel encodeBuffer,
+		 * with the input split into chunks of a multiple of 4 characters. The error reported is the
+		 * one at the lowest offset, just like decodeBuffer would report it.
+		 *
+		 * @param	in			the input base64-encoded string to decode
+		 * @param	out			the output buffer where the decoded string will be stored
+		 * @param	inSize		the length in bytes of the input buffer
+		 * @param	nThreads	the maximum number of threads to decode on, the calling thread included
+		 *
+		 * @return	the length in bytes of the decoded data in the output buffer
+		 *
+		 * @throws	std::runtime_error
+		 *				if the input string is not a valid base64-encoded string
+		 */
+		static ulong decodeBuffer(const char * in, byte * out, ulong inSize, uint nThreads);
+
+		/**
+		 * Decodes a base64-encoded string that may have whitespace (spaces, tabs, newlines, etc.)
+		 * anywhere in it, e.g. a MIME part or a PEM file, and stores the result in the output buffer.
+		 * Once the whitespace is skipped, the string must be a valid base64 encoding.
+		 *
+		 * The input is compacted a few kilobytes at a time into a small buffer, which stays in the
+		 * cache while the decoding kernels run over it, so there's no need for a cleaned-up copy
+		 * of the whole input.
+		 *
+		 * @param	in	the input base64-encoded string to decode
+		 * @param	out	the output buffer where the decoded string will be stored, of at least
+		 *				getDecodedSize(inSize) bytes
+		 * @param	inSize	the length in bytes of the input buffer
+		 *
+		 * @return	the length in bytes of the decoded data in the output buffer
+		 *
+		 * @throws	std::runtime_error
+		 *				if the input string is not a valid base64-encoded string, once the whitespace is skipped
+		 */
+		static ulong decodeBufferLenient(const char * in, byte * out, ulong inSize);
+
+		/**
+		 * Encodes the specified data in base64 into a new string of the exact encoded size,
+		 * which is the only allocation made.
+		 *
+		 * @param	in	the data to encode
+		 *
+		 * @return	the base64-encoded string
+		 */
+		static std::string encode(std::span<const std::byte> in);
+
+		/**
+		 * Encodes the specified data in base64 into storage supplied by the caller, without
+		 * allocating anything.
+		 *
+		 * @param	in	the data to encode
+		 * @param	out	the output buffer, of at least getEncodedSize(in.size()) characters
+		 *
+		 * @return	the number of characters stored in the output buffer
+		 *
+		 * @throws	std::runtime_error
+		 *				if the output buffer is too small
+		 */
+		static ulong encodeInto(std::span<const std::byte> in, std::span<char> out);
+
+		/**
+		 * Decodes a base64-encoded string into a new vector of the exact decoded size, worked out
+		 * from the padding at the end of the string, which is the only allocation made.
+		 *
+		 * @param	in	the base64-encoded string to decode
+		 *
+		 * @return	the decoded data
+		 *
+		 * @throws	std::runtime_error
+		 *				if the input string is not a valid base64-encoded string
+		 */
+		static std::vector<std::byte> decode(std::string_view in);
+
+		/**
+		 * Decodes a base64-encoded string into storage supplied by the caller, without
+		 * allocating anything.
+		 *
+		 * @param	in	the base64-encoded string to decode
+		 * @param	out	the output buffer, of at least getDecodedSize(in.data(), in.size()) bytes
+		 *
+		 * @return	the number of bytes stored in the output buffer
+		 *
+		 * @throws	std::runtime_error
+		 *				if the output buffer is too small, or if the input string is not a valid
+		 *				base64-encoded string
+		 */
+		static ulong decodeInto(std::string_view in, std::span<std::byte> out);
+
+		/**
+		 * Decodes a base64-encoded string into storage supplied by the caller just like decodeInto,
+		 * but reports errors in the returned result instead of throwing.
+		 *
+		 * @param	in	the base64-encoded string to decode
+		 * @param	out	the output buffer, of at least getDecodedSize(in.data(), in.size()) bytes
+		 *
+		 * @return	the number of bytes stored in the output buffer, or the error and where it is
+		 */
+		static DecodeResult tryDecode(std::string_view in, std::span<std::byte> out) noexcept;
+
+		/**
+		 * Encodes data scattered over several fragments, e.g. a chain of network buffers, as if
+		 * they were one contiguous buffer, into contiguous storage supplied by the caller. The 3-byte
+		 * blocks that straddle two or more fragments are put together on the side, so that the
+		 * vectorized kernels run over the rest of every fragment where it lies, without a copy.
+		 *
+		 * @param	fragments	the fragments of the data to encode, in order
+		 * @param	out			the output buffer, of at least getEncodedSize(n) characters, where n is
+		 *						the total size of the fragments
+		 *
+		 * @return	the number of characters stored in the output buffer
+		 *
+		 * @throws	std::runtime_error
+		 *				if the output buffer is too small
+		 */
+		static ulong encodeFragments(std::span<const iovec> fragments, std::span<char> out);
+		static ulong encodeFragments(std::span<const std::span<const std::byte>> fragments, std::span<char> out);
+
+		/**
+		 * Decodes a base64 encoding scattered over several fragments as if they were one contiguous
+		 * string, into contiguous storage supplied by the caller, just like encodeFragments. Errors
+		 * are reported at their offsets in the whole encoding.
+		 *
+		 * @param	fragments	the fragments of the encoding to decode, in order
+		 * @param	out			the output buffer, of at least as many bytes as the encoding decodes to
+		 *
+		 * @return	the number of bytes stored in the output buffer
+		 *
+		 * @throws	std::runtime_error
+		 *				if the output buffer is too small, or if the fragments don't make up a valid
+		 *				base64-encoded string
+		 */
+		static ulong decodeFragments(std::span<const iovec> fragments, std::span<std::byte> out);
+		static ulong decodeFragments(std::span<const std::string_view> fragments, std::span<std::byte> out);
+
+		/**
+		 * Encodes the data at the start of the buffer in base64 over itself, so that large data
+		 * doesn't need a second buffer for its encoding. The data is encoded a few kilobytes at a
+		 * time, from the end of the buffer backwards, each block through a small buffer that stays
+		 * in the cache, so the encoding of a block never overwrites data that wasn't encoded yet.
+		 *
+		 * @param	buffer	the buffer holding the data to encode, of at least getEncodedSize(inSize) bytes
+		 * @param	inSize	the length in bytes of the data at the start of the buffer
+		 *
+		 * @return	the number of characters of the encoding, which starts at the start of the buffer
+		 *
+		 * @throws	std::runtime_error
+		 *				if the buffer is too small
+		 */
+		static ulong encodeInPlace(std::span<std::byte> buffer, ulong inSize);
+
+		/**
+		 * Decodes the base64 encoding filling the buffer over itself, just like encodeInPlace but from
+		 * the start of the buffer forwards, since the decoded data is smaller than its encoding. If
+		 * the encoding is not valid, the buffer is left partially decoded.
+		 *
+		 * @param	buffer	the buffer holding the base64-encoded string to decode
+		 *
+		 * @return	the number of bytes of the decoded data, which starts at the start of the buffer
+		 *
+		 * @throws	std::runtime_error
+		 *				if the buffer does not hold a valid base64-encoded string
+		 */
+		static ulong decodeInPlace(std::span<char> buffer);
+
+		/**
+		 * Encodes many small buffers, e.g. IDs, hashes or cookie values, in one call, without allocating
+		 * anything. The encodings are stored one after the other in the arena, the i-th one from
+		 * offsets[i] up to offsets[i + 1].
+		 *
+		 * Small inputs would barely reach the vectorized kernels one at a time, so they are gathered
+		 * into blocks of a few kilobytes, each encoded in one go, and the last partial block of every
+		 * input is then encoded on its own.
+		 *
+		 * @param	inputs	the buffers to encode
+		 * @param	arena	the output buffer, of at least getEncodedBatchSize(inputs) characters
+		 * @param	offsets	set to the offsets of the encodings in the arena, of at least inputs.size() + 1 entries
+		 *
+		 * @return	the number of characters stored in the arena
+		 *
+		 * @throws	std::runtime_error
+		 *				if the arena or the offsets array is too small
+		 */
+		static ulong encodeBatch(std::span<const std::span<const std::byte>> inputs, std::span<char> arena,
+			std::span<ulong> offsets);
+
+		/**
+		 * Returns the size of the arena encodeBatch needs for the specified inputs.
+		 */
+		static ulong getEncodedBatchSize(std::span<const std::span<const std::byte>> inputs);
+
+		/**
+		 * Decodes many small base64-encoded strings in one call, just like encodeBatch encodes them.
+		 * The decoded data of the i-th string is stored in the arena from offsets[i] up to offsets[i + 1].
+		 *
+		 * @param	inputs	the base64-encoded strings to decode
+		 * @param	arena	the output buffer, of at least getDecodedBatchSize(inputs) bytes
+		 * @param	offsets	set to the offsets of the decoded data in the arena, of at least inputs.size() + 1 entries
+		 *
+		 * @return	the number of bytes stored in the arena
+		 *
+		 * @throws	std::runtime_error
+		 *				if the arena or the offsets array is too small, or if one of the strings is not a
+		 *				valid base64-encoded string, in which case the message gives its index
+		 */
+		static ulong decodeBatch(std::span<const std::string_view> inputs, std::span<std::byte> arena,
+			std::span<ulong> offsets);
+
+		/**
+		 * Returns the size of the arena decodeBatch needs for the specified inputs, which is exact.
+		 */
+		static ulong getDecodedBatchSize(std::span<const std::string_view> inputs);
+
+		/**
+		 * Encodes the input buffer just like encodeBuffer, a block at a time, in a way that can
+		 * run at compile time, e.g. to build constants. At run time, encodeBuffer is much faster.
+		 *
+		 * @return	the length in bytes of the encoded data in the output buffer
+		 */
+		static constexpr ulong encodeConstexpr(const byte * in, char * out, ulong inSize);
+
+		/**
+		 * Decodes the input buffer just like decodeBuffer, a block at a time, in a way that can
+		 * run at compile time. At compile time, an invalid encoding doesn't compile; at run time,
+		 * it throws, with a less detailed message than decodeBuffer's.
+		 *
+		 * @return	the length in bytes of the decoded data in the output buffer
+		 *
+		 * @throws	std::runtime_error
+		 *				if the input string is not a valid base64-encoded string
+		 */
+		static constexpr ulong decodeConstexpr(const char * in, byte * out, ulong inSize);
+
+		/**
+		 * Encodes an array at compile time (or at run time) into an array of the exact size.
+		 */
+		template <ulong N>
+		static constexpr std::array<char, getEncodedSize(N)> encodeArray(const std::array<byte, N> & in)
+		{
+			std::array<char, getEncodedSize(N)> out = {};
+			encodeConstexpr(in.data(), out.data(), N);
+			return out;
+		}
+
+		/**
+		 * Decodes a string literal at compile time into an array of the exact size, so that
+		 * embedded keys, certificates and the like cost nothing at startup. A malformed literal
+		 * doesn't compile.
+		 *
+		 *		constexpr auto key = Base64Url::decodeLiteral<"q83vEjRWeJA">();
+		 */
+		template <Base64Literal literal>
+		static consteval std::array<byte, getDecodedSize(literal.chars, literal.size)> decodeLiteral()
+		{
+			std::array<byte, getDecodedSize(literal.chars, literal.size)> out = {};
+			decodeConstexpr(literal.chars, out.data(), literal.size);
+			return out;
+		}
 		
 		/**
 		 * Encodes a file in base64 and stores the result in a different file.
@@ -68,30 +823,289 @@ class Base64
 		 * @param	outFile		path to the destination file where the encoded file will be stored
 		 * @param	newline		the newline characters that will be used to separate the base64-encoded lines
 		 * @param	lineSize	the size of a base64-encoded line in the file
+		 * @param	nThreads	the number of threads to encode the file on; with more than one thread,
+		 *						the file is encoded just like encodeFileMapped does
 		 *
 		 * @throws	std::runtime_error	
 		 *				if there's an I/O error, if the line size is not a multiple of 4, 
 		 * 				or if the input file is empty
 		 */
-		static void encodeFile(const char * inFile, const char * outFile, const char * newline = "\r\n", uint lineSize = 76)
-			throw (std::runtime_error);
+		static void encodeFile(const char * inFile, const char * outFile, const char * newline = "\r\n", uint lineSize = 76,
+			uint nThreads = 1);
 		
 		/**
-		 * Decodes a base64-encoded file and stores it in another file.
+		 * Decodes a base64-encoded file and stores it in another file. The lines can be of any
+		 * size, e.g. what `base64 -w 70` produces: they're decoded as one encoding, except that
+		 * a line ending in padding completes its encoding, and the next line starts a new one.
 		 *
 		 * @param	inFile		path to the input base64-encoded file to be decoded
 		 * @param	outFile		path to the destination file where the decoded file will be stored
+		 * @param	nThreads	the number of threads to decode the file on; with more than one thread,
+		 *						the file is decoded just like decodeFileMapped does
 		 *
 		 * @throws	std::runtime_error	
 		 *				if there's an I/O error, if the input file is empty, 
 		 *				or if the file is not a valid base64-encoded file
 		 */
-		static void decodeFile(const char * inFile, const char * outFile) throw (std::runtime_error);
+		static void decodeFile(const char * inFile, const char * outFile, uint nThreads = 1);
+
+		/**
+		 * Returns the size of the file encodeFile produces for an input file of the specified size.
+		 *
+		 * @param	inputSize	the size of the input file
+		 * @param	newline		the newline characters that separate the base64-encoded lines
+		 * @param	lineSize	the size of a base64-encoded line in the file
+		 */
+		static ulong getEncodedFileSize(ulong inputSize, const char * newline = "\r\n", uint lineSize = 76);
+
+		/**
+		 * Encodes a file just like encodeFile, but through memory mappings of the input and output
+		 * files. The output file is allocated with its exact final size up front and the data is
+		 * encoded straight from one mapping to the other, without any intermediate copies.
+		 *
+		 * Since every line holds the same number of input bytes, where each input byte ends up in
+		 * the output is known in advance. So the input is split into chunks of whole lines, which
+		 * are encoded on up to nThreads threads at once.
+		 *
+		 * @see	encodeFile
+		 */
+		static void encodeFileMapped(const char * inFile, const char * outFile, const char * newline = "\r\n", uint lineSize = 76,
+			uint nThreads = 1);
+
+		/**
+		 * Decodes a file just like decodeFile, but through memory mappings of the input and output
+		 * files, in two passes over chunks of whole lines that run on up to nThreads threads at once.
+		 * The first pass counts the characters of every chunk and finds the lines that end in padding,
+		 * from which the size of every decoded chunk is worked out, and the second pass decodes each
+		 * chunk at its offset in the output file, which is allocated with its exact size in between,
+		 * picking up the characters of a block split by the previous chunk. Errors are reported on
+		 * the same line decodeFile reports them.
+		 *
+		 * @see	decodeFile
+		 */
+		static void decodeFileMapped(const char * inFile, const char * outFile, uint nThreads = 1);
+
+		/**
+		 * Encodes data that arrives in chunks of any size, e.g. off the network, without having to
+		 * put it all in one buffer first. Up to 2 bytes of each chunk are kept until the next call,
+		 * so that the output is exactly what encodeBuffer would produce for the whole data.
+		 */
+		class Encoder
+		{
+			public:
+				Encoder() : _pendingSize(0) {}
+
+				/**
+				 * Returns the size of the output buffer needed by update for a chunk of the specified size.
+				 */
+				static ulong getMaxUpdateSize(ulong inSize) { return (inSize + 2) / 3 * 4; }
+
+				/**
+				 * Encodes the specified chunk, along with the bytes left over from the previous call.
+				 *
+				 * @param	in			the chunk to encode
+				 * @param	out			the output buffer, of at least getMaxUpdateSize(inSize) characters
+				 * @param	inSize		the length in bytes of the chunk
+				 *
+				 * @return	the number of characters stored in the output buffer
+				 */
+				ulong update(const byte * in, char * out, ulong inSize);
+
+				/**
+				 * Encodes the bytes left over from the previous calls, padding them if needed, and
+				 * gets the encoder ready for new data.
+				 *
+				 * @param	out		the output buffer, of at least 4 characters
+				 *
+				 * @return	the number of characters stored in the output buffer, 0 or 4 (or fewer
+				 *			without padding)
+				 */
+				ulong finish(char * out);
+
+			private:
+				byte _pending[3];
+				uint _pendingSize;
+		};
+
+		/**
+		 * Decodes base64-encoded data that arrives in chunks of any size. Up to 3 characters of
+		 * each chunk are kept until the next call. Once a padded block was decoded, the encoding
+		 * is considered complete and any more data is an error.
+		 */
+		class Decoder
+		{
+			public:
+				Decoder() : _pendingSize(0), _offset(0), _padded(false) {}
+
+				/**
+				 * Returns the size of the output buffer needed by update for a chunk of the specified size.
+				 */
+				static ulong getMaxUpdateSize(ulong inSize) { return (inSize + 3) / 4 * 3; }
+
+				/**
+				 * Decodes the specified chunk, along with the characters left over from the previous call.
+				 *
+				 * @param	in			the base64-encoded chunk to decode
+				 * @param	out			the output buffer, of at least getMaxUpdateSize(inSize) bytes
+				 * @param	inSize		the length in bytes of the chunk
+				 *
+				 * @return	the number of bytes stored in the output buffer
+				 *
+				 * @throws	std::runtime_error
+				 *				if the chunk has an invalid character, or if it comes after padding
+				 */
+				ulong update(const char * in, byte * out, ulong inSize);
+
+				/**
+				 * Checks that the data decoded so far was a complete encoding, decodes the partial
+				 * block it ends in if the alphabet has no padding, and gets the decoder ready for new data.
+				 *
+				 * @param	out		the output buffer, of at least 3 bytes
+				 *
+				 * @return	the number of bytes stored in the output buffer
+				 *
+				 * @throws	std::runtime_error
+				 *				if the length of the data is not valid, or if the partial block has
+				 *				an invalid character
+				 */
+				ulong finish(byte * out);
+
+				/**
+				 * Gets the decoder ready to decode the rest of an encoding whose first offset characters
+				 * were decoded elsewhere, for instance by another decoder on another thread.
+				 *
+				 * @param	offset		the number of characters of the encoding before the rest
+				 * @param	padded		whether the last complete block of those characters ends in padding
+				 * @param	pending		the characters after that block, offset % 4 of them
+				 */
+				void resume(ulong offset, bool padded, const char * pending);
+
+				/**
+				 * @return	true if the data decoded so far ends a block, with no characters left over
+				 */
+				bool atBlockBoundary() const { return _pendingSize == 0; }
+
+			private:
+				/**
+				 * Decodes complete 4-character blocks, checking that none comes after padding.
+				 */
+				ulong decodeBlocks(const char * in, byte * out, ulong inSize);
+
+				char _pending[4];
+				uint _pendingSize;
+				ulong _offset;
+				bool _padded;
+		};
 		
 	private:
+		/**
+		 * The size of the blocks the file methods read and write at a time.
+		 */
+		static const ulong _fileBlockSize = 4 << 20;
+
+		/**
+		 * The size of the buffer the input of decodeBufferLenient() is compacted into, small
+		 * enough to stay in the L1 cache.
+		 */
+		static const ulong _lenientBlockSize = 4096;
+
+		/**
+		 * The size of the blocks the small inputs of encodeBatch() are gathered into, a multiple
+		 * of 3 whose encoding fills 4 KB. decodeBatch() gathers its inputs into blocks of 4 KB.
+		 */
+		static const ulong _batchBlockSize = 3072;
+
+		/**
+		 * The size of the chunks the parallel encodeBuffer splits its input into, a multiple of 3
+		 * whose encoding is 1 MB, big enough to make up for handing it to a thread. The parallel
+		 * decodeBuffer splits its input into chunks of 1 MB. Inputs under _parallelMinSize bytes,
+		 * two chunks' worth of encoding, stay on the calling thread.
+		 */
+		static const ulong _parallelChunkSize = 3 << 18;
+		static const ulong _parallelMinSize = 2 << 20;
+
+		/**
+		 * The size of the blocks encodeInPlace() copies aside before encoding them, a multiple of 3
+		 * whose encoding fills 4 KB. decodeInPlace() copies aside blocks of 4 KB of encoding.
+		 */
+		static const ulong _inPlaceBlockSize = 3072;
+		
+		/**
+		 * The number of characters decodeFileMapped() decodes into a buffer at a time, so that
+		 * invalid data can't make a chunk write past its part of the output file.
+		 */
+		static const ulong _mappedStageSize = 4096;
+
+		/**
+		 * Encodes the input buffer as lines of the specified size, each one followed by the newline
+		 * characters. The last line is shorter than the others when the input size is not a multiple
+		 * of the number of bytes in a line.
+		 *
+		 * @param	in			the input buffer to encode
+		 * @param	out			the output buffer where the base64-encoded lines will be stored
+		 * @param	inSize		the length in bytes of the input buffer
+		 * @param	newline		the newline characters that will be used to separate the base64-encoded lines
+		 * @param	lineSize	the size of a base64-encoded line, a multiple of 4
+		 *
+		 * @return	the length in bytes of the encoded lines in the output buffer
+		 */
+		static ulong encodeLines(const byte * in, char * out, ulong inSize, const char * newline, uint lineSize);
+
+		/**
+		 * Builds the exception thrown when decoding runs into an invalid character.
+		 *
+		 * @param	ch		the invalid character
+		 * @param	offset	the offset of the invalid character in the input
+		 */
+		static std::runtime_error invalidCharError(char ch, ulong offset);
+
+		/**
+		 * Builds the exception thrown when decoding runs into an encoding of a length isValidLength
+		 * rejects, which is worded after what the alphabet accepts: a multiple of 4 with padding,
+		 * or anything but a single character in the last block without.
+		 *
+		 * @param	what	what the length is of, e.g. "base64-encoded line"
+		 * @param	length	the invalid length
+		 */
+		static std::runtime_error invalidLengthError(const char * what, ulong length);
+
+		/**
+		 * Builds the exception the throwing decoding methods throw for an error reported by
+		 * the non-throwing ones.
+		 *
+		 * @param	result	the result of decoding the input
+		 * @param	in		the input that was decoded
+		 */
+		static std::runtime_error decodeError(const DecodeResult & result, const char * in);
+
+		/**
+		 * The implementations of encodeFragments and decodeFragments, for every kind of fragment.
+		 */
+		template <class Fragment>
+		static ulong encodeFragmentsOf(std::span<const Fragment> fragments, std::span<char> out);
+		template <class Fragment>
+		static ulong decodeFragmentsOf(std::span<const Fragment> fragments, std::span<std::byte> out);
+
+		/**
+		 * Builds the exception thrown when one of the inputs of a batch can't be decoded, out of
+		 * the one decoding it on its own would have thrown.
+		 *
+		 * @param	index	the index of the input in the batch
+		 * @param	error	the error of the input
+		 */
+		static std::runtime_error batchError(ulong index, const std::runtime_error & error);
+
+		/**
+		 * Tells whether an encoding can be of the specified length: a multiple of 4 with padding,
+		 * and anything but one more than a multiple of 4 without, since a single character can't
+		 * encode a whole byte.
+		 */
+		static constexpr bool isValidLength(ulong length) { return Alphabet::padding ? length % 4 == 0 : length % 4 != 1; }
+
 		/**
 		 * Returns the offset in the base64 alphabet of the specified character.
-		 * This method is used when decoding a 4-byte base64-encoded block.
+		 * This method is used when decoding a 4-byte base64-encoded block, at compile time
+		 * as well as at run time.
 		 *
 		 * @param	ch	the character to look up in the alphabet
 		 *
@@ -100,7 +1114,7 @@ class Base64
 		 * @throws	std::runtime_error 
 		 *				if the character is not in the alphabet
 		 */
-		static byte charToByte(char ch) throw (std::runtime_error);
+		static constexpr byte charToByte(char ch);
 		
 		/**
 		 * Returns the character mapped to the specified number in 
@@ -110,7 +1124,7 @@ class Base64
 		 *
 		 * @return	the ASCII character corresponding to that number
 		 */
-		static char byteToChar(byte number) { return _byteToChar[number]; }
+		static constexpr char byteToChar(byte number) { return _tables.byteToChar[number]; }
 		
 		/**
 		 * Encodes a block of up to 24 bits (3 Buffer) to 4 characters in base64.
@@ -119,12 +1133,12 @@ class Base64
 		 * @param	out			the output buffer where the encoded data will be stored
 		 * @param	inLength	size in bytes of the input block, will usually be 3
 		 */
-		static void encodeBlock(const byte in[3], char out[4], uint inLength);
+		static constexpr void encodeBlock(const byte in[3], char out[4], uint inLength);
 		
 		/**
 		 * Decodes a base64-encoded 4-character block to a 3-byte block of data and returns
 		 * the length of the decoded block, which could be less than 3 Buffer when padding was
-		 * present.
+		 * present. Only the decoded bytes are stored.
 		 *
 		 * @param	in	the input base64-encoded 4-character block
 		 * @param	out the output buffer where the decoded data will be stored
@@ -135,17 +1149,338 @@ class Base64
 		 *				if the characters in the input string are not in the base64
 		 *				alphabet
 		 */
-		static uint decodeBlock(const char in[4], byte out[3]) throw (std::runtime_error);
-		
+		static constexpr uint decodeBlock(const char in[4], byte out[3]);
+
+		/**
+		 * Decodes a base64-encoded buffer in a single pass, validating the characters as they are
+		 * decoded. Every character is looked up in the charToByte table and the results are OR'ed
+		 * together, so that an invalid character is detected by a single check on the accumulated
+		 * sentinel bit, instead of a branch on every character.
+		 *
+		 * @param	in				the input base64-encoded string to decode, of a length isValidLength accepts
+		 * @param	out				the output buffer where the decoded data will be stored
+		 * @param	inSize			the length in bytes of the input buffer
+		 * @param	decodedLength	set to the length in bytes of the decoded data in the output buffer
+		 *
+		 * @return	the offset of the first invalid character in the input buffer, or inSize
+		 *			if the input buffer is a valid base64 encoding
+		 */
+		static ulong decodeFused(const char * in, byte * out, ulong inSize, ulong & decodedLength);
+
+		/**
+		 * Vectorized encoding kernels, defined in Base64Ssse3.cpp, Base64Avx2.cpp and Base64Avx512.cpp.
+		 * Each of those files is compiled for its own instruction set, so the kernels must only be
+		 * called through the kernels of the backend in use, which the CPU is known to support.
+		 *
+		 * Each kernel encodes as many whole 24-byte (SSSE3) or 48-byte (AVX2 and AVX-512) blocks
+		 * from the beginning of the input as it can without reading past its end, and leaves the
+		 * rest to the next kernel of its backend, or to the scalar encodeBlock.
+		 *
+		 * @param	in			the input buffer to encode
+		 * @param	out			the output buffer where the base64-encoded string will be stored
+		 * @param	inSize		the length in bytes of the input buffer
+		 *
+		 * @return	the number of input bytes that were encoded, always a multiple of 3
+		 */
+		static ulong encodeSsse3(const byte * in, char * out, ulong inSize);
+		static ulong encodeAvx2(const byte * in, char * out, ulong inSize);
+		static ulong encodeAvx512(const byte * in, char * out, ulong inSize);
+
+		/**
+		 * Vectorized decoding kernels, defined in Base64Avx2.cpp and Base64Avx512.cpp.
+		 *
+		 * Each kernel validates and decodes 32 (AVX2) or 64 (AVX-512) characters at a time, and stops
+		 * at the first block that contains an invalid character, before the last block of the input
+		 * (which might be padded) or when there are not enough characters left. The rest of the input
+		 * is left to the next kernel of its backend, and eventually to the scalar code, which also
+		 * takes care of locating the invalid character, if any.
+		 *
+		 * The AVX-512 kernels translate between numbers and characters with vpermb and vpermi2b
+		 * lookups straight into the byteToChar and charToByte tables.
+		 *
+		 * @param	in			the input base64-encoded string to decode
+		 * @param	out			the output buffer where the decoded data will be stored
+		 * @param	inSize		the length in bytes of the input buffer
+		 *
+		 * @return	the number of input characters that were decoded, always a multiple of 4
+		 */
+		static ulong decodeAvx2(const char * in, byte * out, ulong inSize);
+		static ulong decodeAvx512(const char * in, byte * out, ulong inSize);
+
+		/**
+		 * Vectorized validation kernels, defined in Base64Ssse3.cpp, Base64Avx2.cpp and Base64Avx512.cpp.
+		 *
+		 * Each kernel classifies 16 (SSSE3), 32 (AVX2) or 64 (AVX-512) characters at a time, the
+		 * same way the decoding kernels of its instruction set do, and stops at the first vector that
+		 * contains a character outside the alphabet or when there are not enough characters left.
+		 * The input never includes the last block, which might be padded.
+		 *
+		 * @param	in			the base64-encoded string to check
+		 * @param	inSize		the length in bytes of the string
+		 *
+		 * @return	the number of characters at the beginning of the string that are in the alphabet
+		 */
+		static ulong validateSsse3(const char * in, ulong inSize);
+		static ulong validateAvx2(const char * in, ulong inSize);
+		static ulong validateAvx512(const char * in, ulong inSize);
+
+		/**
+		 * Portable SWAR (SIMD within a register) kernels, defined in Base64Swar.cpp, used by
+		 * the SWAR backend and for whatever the vectorized kernels leave behind.
+		 *
+		 * The encoding kernel turns 6 bytes into 8 characters at a time, with four lookups in a
+		 * 4096-entry table of character pairs. The decoding kernel OR's together four lookups
+		 * in tables of pre-shifted 32-bit words to get 3 decoded bytes, and checks the high
+		 * bit of the words once every 64 characters to detect invalid characters.
+		 */
+		static ulong encodeSwar(const byte * in, char * out, ulong inSize);
+		static ulong decodeSwar(const char * in, byte * out, ulong inSize);
+
+		/**
+		 * The lookup tables of the SWAR kernels, built on first use.
+		 */
+		struct SwarTables;
+		static const SwarTables & swarTables();
+
+		/**
+		 * Copies the input buffer to the output buffer, skipping whitespace, using the compaction
+		 * kernel of the backend in use, if any.
+		 *
+		 * @return	the number of characters stored in the output buffer
+		 */
+		static ulong compactWhitespace(const char * in, char * out, ulong inSize);
+
+		typedef ulong (*EncodeKernel)(const byte * in, char * out, ulong inSize);
+		typedef ulong (*DecodeKernel)(const char * in, byte * out, ulong inSize);
+		typedef ulong (*ValidateKernel)(const char * in, ulong inSize);
+		typedef ulong (*CompactKernel)(const char * in, char * out, ulong inSize, ulong & outLength);
+
+		/**
+		 * The maximum number of kernels a backend can chain together.
+		 */
+		static const uint _maxKernels = 4;
+
+		/**
+		 * The kernels a backend is made of. The encoding (or decoding, or validation) kernels are run
+		 * one after the other, each one picking up where the previous one stopped, until a NULL entry.
+		 * The compaction kernel is NULL for backends that compact whitespace with scalar code.
+		 */
+		struct Kernels
+		{
+			EncodeKernel encode[_maxKernels];
+			DecodeKernel decode[_maxKernels];
+			ValidateKernel validate[_maxKernels];
+			CompactKernel compact;
+		};
+
+		/**
+		 * Returns the kernels of the backend in use, picking the backend on the first call.
+		 */
+		static const Kernels & kernels();
+
+		/**
+		 * Runs the encoding kernels of the backend in use over the input buffer.
+		 *
+		 * @return	the number of input bytes that were encoded, always a multiple of 3
+		 */
+		static ulong encodeKernels(const byte * in, char * out, ulong inSize);
+
+		/**
+		 * Runs the decoding kernels of the backend in use over the input buffer.
+		 *
+		 * @return	the number of input characters that were decoded, always a multiple of 4
+		 */
+		static ulong decodeKernels(const char * in, byte * out, ulong inSize);
+
+		/**
+		 * Runs the validation kernels of the backend in use over the input buffer.
+		 *
+		 * @return	the number of characters at the beginning of the input that are in the alphabet
+		 */
+		static ulong validateKernels(const char * in, ulong inSize);
+
 	private:
-		
+
+		/**
+		 * The kernels of every backend, indexed by Backend.
+		 */
+		static const Kernels _kernels[NUM_BACKENDS];
+
+		/**
+		 * The value stored in the charToByte table for characters outside the base64 alphabet.
+		 * Its high bit is never set for valid characters, which have values between 0 and 63.
+		 */
+		static const byte _invalidChar = 0xFF;
+
 		/**
-		 * The base64 alphabet associates a number to each symbol (letter, digit, etc.) in it.
+		 * The base64 alphabet, which associates a number to each symbol (letter, digit, etc.) in it,
+		 * and its reverse, which maps every ASCII character to its offset in the alphabet, or to
+		 * _invalidChar if the character is not in the alphabet.
 		 */
-		static const char _byteToChar[64];
+		static constexpr Base64Tables<Alphabet> _tables = Base64Tables<Alphabet>();
 		
 		/**
-		 * The padding character used for encoding blocks that are less than 3 Buffer long
+		 * The padding character used for encoding blocks that are less than 3 Buffer long,
+		 * if the alphabet pads them.
 		 */
-		static const char _paddingChar;
+		static const char _paddingChar = '=';
 };
+
+template <class Alphabet>
+constexpr void BasicBase64<Alphabet>::encodeBlock(const byte in[3], char out[4], uint inLength)
+{
+	/**
+	 * Encoding three bytes works by splitting the 3 x 8 = 24 byte block
+	 * into 4 blocks of 6 bytes. This is done using bitwise operations. Each one of the
+	 * resulting 4 blocks will represent a number in the 0 to 63 range. 
+	 * Each number is associated with a character in the base64 table.
+	 * 
+	 * Once we transform the 3 bytes into the 4 6-bit numbers, we'll replace the
+	 * 4 6-bit numbers by their corresponding characters in the table and get
+	 * the final base64 encoded block.
+	 *
+	 *	Of course, you also have to deal with padding, which involves a few checks.
+	 */
+	
+	out[0] = byteToChar(in[0] >> 2);
+	if(Alphabet::padding)
+		out[2] = out[3] = _paddingChar;
+	
+	out[1] = byteToChar(
+		((in[0] & 0x03) << 4) |
+		(inLength > 1 ? (((in[1] & 0xF0)) >> 4) : 0)
+	);
+	
+	if(inLength >= 2)
+	{
+		out[2] = byteToChar(
+			((in[1] & 0x0F) << 2) | 
+			(inLength == 3 ? ((in[2] & 0xC0) >> 6) : 0)
+		);
+		
+		if(inLength == 3)
+			out[3] = byteToChar(in[2] & 0x3F);
+	}
+}
+
+template <class Alphabet>
+constexpr uint BasicBase64<Alphabet>::decodeBlock(const char in[4], byte out[3])
+{
+	/**
+	 *	Decoding a 4-character blocks is just the reverse of encoding. You look at each character
+	 *	and get its offset in the base64 alphabet. This will be a 6 bit number. You do this for all
+	 *	4 characters and you'll get 6 x 4 = 24 bits = 3 bytes. These 3 bytes obtained by concatenating
+	 *	all those 6 bits will be the decoded data.
+	 *
+	 *	Of course, you also have to deal with padding, which involves a few checks.
+	 */
+	 
+	/**
+	 * The length of the decoded data will be stored here
+	 * and returned when the function exits.
+	 */
+	uint length = 1;
+	
+	out[0] = (charToByte(in[0]) << 2) | ((charToByte(in[1]) & 0x30) >> 4);
+
+	/**
+	 * If the 3rd input char is not a padding char, then go ahead and
+	 * decode it, storing it in the 2nd output byte.
+	 */
+	if(in[2] != _paddingChar)
+	{
+		out[1] = ((charToByte(in[1]) & 0x0F) << 4) | ((charToByte(in[2]) & 0x3C) >> 2);
+		length += 1;
+		
+		/**
+		 * If the 4th input char is also not a padding char, then go ahead and decode it,
+		 * storing it in the 3rd output byte.
+		 */
+		if(in[3] != _paddingChar)
+		{
+			out[2] = ((charToByte(in[2]) & 0x03) << 6) | (charToByte(in[3]) & 0x3F);
+			length += 1;
+		}
+	}
+	/**
+	 * Otherwise, if the 3rd input char is a padding char, 
+	 * then make sure the 4th one is also a padding char.
+	 */
+	else if(in[3] != _paddingChar)
+		throw std::runtime_error("Non-padding char encountered immediately after padding char.");
+	
+	return length;
+}
+
+template <class Alphabet>
+constexpr byte BasicBase64<Alphabet>::charToByte(char ch)
+{
+	byte number = _tables.charToByte[static_cast<byte>(ch)];
+
+	if(number == _invalidChar)
+		throw std::runtime_error("Invalid character detected in the base64-encoded input.");
+
+	return number;
+}
+
+template <class Alphabet>
+constexpr ulong BasicBase64<Alphabet>::encodeConstexpr(const byte * in, char * out, ulong inSize)
+{
+	ulong outLength = 0;
+	
+	for(ulong done = 0; done < inSize; done += 3)
+	{
+		uint size = inSize - done < 3 ? inSize - done : 3;
+		encodeBlock(in + done, out + outLength, size);
+		outLength += getEncodedSize(size);
+	}
+	
+	return outLength;
+}
+
+template <class Alphabet>
+constexpr ulong BasicBase64<Alphabet>::decodeConstexpr(const char * in, byte * out, ulong inSize)
+{
+	if(!isValidLength(inSize))
+		throw std::runtime_error("The length of the base64-encoded data is not valid.");
+	
+	ulong outLength = 0;
+	
+	for(ulong done = 0; done < inSize; done += 4)
+	{
+		/**
+		 * Without padding, the last block can be partial, and is padded here for decodeBlock.
+		 * Actual padding is only allowed at the end of a padded encoding.
+		 */
+		char block[4] = { _paddingChar, _paddingChar, _paddingChar, _paddingChar };
+		ulong size = inSize - done < 4 ? inSize - done : 4;
+		
+		for(ulong i = 0; i < size; i++)
+		{
+			block[i] = in[done + i];
+			if(block[i] == _paddingChar && (!Alphabet::padding || done + 4 < inSize))
+				throw std::runtime_error("Padding character found before the end of the base64-encoded data.");
+		}
+		
+		outLength += decodeBlock(block, out + outLength);
+	}
+	
+	return outLength;
+}
+
+/**
+ * The standard base64 codec, and the URL and filename safe ones, with and without padding.
+ */
+typedef BasicBase64<StandardAlphabet> Base64;
+typedef BasicBase64<UrlAlphabet> Base64Url;
+typedef BasicBase64<UrlUnpaddedAlphabet> Base64UrlUnpadded;
+
+/**
+ * Decodes a standard base64 string literal at compile time: "SGVsbG8="_base64 is an
+ * std::array holding the 5 bytes of "Hello".
+ */
+template <Base64Literal literal>
+consteval auto operator""_base64()
+{
+	return Base64::decodeLiteral<literal>();
+}
@@ -0,0 +1,269 @@
+/**
+ *	File:		Base64Avx2.cpp
+ *	Author:		Alin Tomescu, tomescu.alin@gmail.com
+ *	Website:	http://alinush.org
+ *	Date: 		October 16th, 2026
+ *	License:	Free to use and distribute as long as this notice is kept.
+ */
+#include "Base64.h"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+/**
+ * Loads two 12-byte groups, the first one from lo and the second one from hi, into
+ * the two 128-bit lanes of a vector. Each load reads 16 bytes.
+ */
+static inline __m256i loadLanes(const byte * lo, const byte * hi)
+{
+	return _mm256_inserti128_si256(
+		_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lo))),
+		_mm_loadu_si128(reinterpret_cast<const __m128i *>(hi)), 1);
+}
+
+/**
+ * Encodes the first 12 bytes of each 128-bit lane of the specified vector into
+ * 32 base64 characters. This is the same algorithm as the SSSE3 kernel, applied
+ * to both lanes at once.
+ */
+template <class Alphabet>
+static inline __m256i encodeVector(__m256i in)
+{
+	in = _mm256_shuffle_epi8(in, _mm256_set_epi8(
+		10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+		10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+	
+	__m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00));
+	__m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+	__m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0));
+	__m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+	__m256i indices = _mm256_or_si256(t1, t3);
+	
+	__m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+	__m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+	range = _mm256_or_si256(range, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+	
+	const __m256i offsets = _mm256_setr_epi8(
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, Alphabet::char62 - 62, Alphabet::char63 - 63, 'A', 0, 0,
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, Alphabet::char62 - 62, Alphabet::char63 - 63, 'A', 0, 0);
+	
+	return _mm256_add_epi8(_mm256_shuffle_epi8(offsets, range), indices);
+}
+
+/**
+ * Loads a 16-byte table into both 128-bit lanes of a vector.
+ */
+static inline __m256i loadTable(const void * table)
+{
+	return _mm256_broadcastsi128_si256(_mm_loadu_si128(static_cast<const __m128i *>(table)));
+}
+
+/**
+ * Translates 32 base64 characters to their 6-bit numbers. The characters are classified
+ * by their high and low nibbles: every nibble is looked up in a table of bit flags, and a
+ * character is in the alphabet only if the flags of its two nibbles have no bit in common.
+ * The nibble tables of the alphabet are computed at compile time.
+ *
+ * @param	in		the 32 characters to translate
+ * @param	tables	the lookup tables of the alphabet
+ * @param	valid	set to false if any of the characters is not in the alphabet
+ */
+template <class Alphabet>
+static inline __m256i translateVector(__m256i in, const Base64Tables<Alphabet> & tables, bool & valid)
+{
+	typedef Base64Tables<Alphabet> Tables;
+	
+	const __m256i loNibbleFlags = loadTable(tables.loNibbleFlags);
+	const __m256i hiNibbleFlags = loadTable(tables.hiNibbleFlags);
+	const __m256i offsets = loadTable(tables.nibbleOffsets);
+	
+	__m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), _mm256_set1_epi8(0x0F));
+	__m256i loNibbles = _mm256_and_si256(in, _mm256_set1_epi8(0x0F));
+	__m256i hiFlags = _mm256_shuffle_epi8(hiNibbleFlags, hiNibbles);
+	__m256i loFlags = _mm256_shuffle_epi8(loNibbleFlags, loNibbles);
+	
+	valid = _mm256_testz_si256(loFlags, hiFlags);
+	
+	/**
+	 * The offset that turns a character into its 6-bit number only depends on its high
+	 * nibble, except for the characters of 62 and 63, which share their high nibbles with
+	 * other characters (or each other); their indices are moved to entries of their own.
+	 */
+	__m256i is62 = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(Alphabet::char62));
+	__m256i is63 = _mm256_cmpeq_epi8(in, _mm256_set1_epi8(Alphabet::char63));
+	__m256i index = _mm256_add_epi8(hiNibbles, 
+		_mm256_and_si256(is62, _mm256_set1_epi8(Tables::char62Slot - (Alphabet::char62 >> 4))));
+	index = _mm256_add_epi8(index, 
+		_mm256_and_si256(is63, _mm256_set1_epi8(Tables::char63Slot - (Alphabet::char63 >> 4))));
+	
+	return _mm256_add_epi8(in, _mm256_shuffle_epi8(offsets, index));
+}
+
+/**
+ * Classifies 32 characters by their nibbles, the same way translateVector does, without
+ * translating them. The returned vector is zero only if all of them are in the alphabet.
+ */
+static inline __m256i classifyVector(__m256i in, __m256i loNibbleFlags, __m256i hiNibbleFlags)
+{
+	__m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), _mm256_set1_epi8(0x0F));
+	__m256i loNibbles = _mm256_and_si256(in, _mm256_set1_epi8(0x0F));
+	
+	return _mm256_and_si256(_mm256_shuffle_epi8(loNibbleFlags, loNibbles), _mm256_shuffle_epi8(hiNibbleFlags, hiNibbles));
+}
+
+/**
+ * Packs the 32 6-bit numbers in the specified vector into 24 bytes, which end up
+ * at the beginning of the returned vector.
+ */
+static inline __m256i packVector(__m256i numbers)
+{
+	/**
+	 * Merge pairs of numbers into 12-bit values and then pairs of
+	 * those into 24-bit values, one in each 32-bit lane.
+	 */
+	__m256i pairs = _mm256_maddubs_epi16(numbers, _mm256_set1_epi32(0x01400140));
+	__m256i groups = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+	
+	/**
+	 * Put the 3 bytes of each group in big-endian order at the beginning of
+	 * each 128-bit lane, then close the gap between the two lanes.
+	 */
+	groups = _mm256_shuffle_epi8(groups, _mm256_setr_epi8(
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+		2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+	
+	return _mm256_permutevar8x32_epi32(groups, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1));
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeAvx2(const char * in, byte * out, ulong inSize)
+{
+	/**
+	 * Each iteration decodes 32 characters into 24 bytes. The last block of the input
+	 * might be padded, so it is always left to the scalar code.
+	 */
+	ulong done = 0;
+	
+	while(done + 36 <= inSize)
+	{
+		__m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + done));
+		
+		bool valid;
+		__m256i numbers = translateVector(chars, _tables, valid);
+		if(!valid)
+			break;
+		
+		__m256i bytes = packVector(numbers);
+		
+		byte * outPtr = out + done / 4 * 3;
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(outPtr), _mm256_castsi256_si128(bytes));
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(outPtr + 16), _mm256_extracti128_si256(bytes, 1));
+		
+		done += 32;
+	}
+	
+	return done;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::validateAvx2(const char * in, ulong inSize)
+{
+	const __m256i loNibbleFlags = loadTable(_tables.loNibbleFlags);
+	const __m256i hiNibbleFlags = loadTable(_tables.hiNibbleFlags);
+	
+	/**
+	 * Each iteration checks 64 characters, with a single test for both vectors.
+	 */
+	ulong done = 0;
+	
+	while(done + 64 <= inSize)
+	{
+		__m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + done));
+		__m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + done + 32));
+		__m256i invalid = _mm256_or_si256(classifyVector(lo, loNibbleFlags, hiNibbleFlags),
+			classifyVector(hi, loNibbleFlags, hiNibbleFlags));
+		
+		if(!_mm256_testz_si256(invalid, invalid))
+			break;
+		
+		done += 64;
+	}
+	
+	if(done + 32 <= inSize)
+	{
+		__m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + done));
+		__m256i invalid = classifyVector(chars, loNibbleFlags, hiNibbleFlags);
+		
+		if(_mm256_testz_si256(invalid, invalid))
+			done += 32;
+	}
+	
+	return done;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeAvx2(const byte * in, char * out, ulong inSize)
+{
+	/**
+	 * Each iteration encodes 48 bytes into 64 characters. The last 16-byte
+	 * load starts at offset 36, so stop while there are at least 52 bytes left.
+	 */
+	ulong done = 0;
+	
+	while(done + 52 <= inSize)
+	{
+		const byte * inPtr = in + done;
+		__m256i lo = loadLanes(inPtr, inPtr + 12);
+		__m256i hi = loadLanes(inPtr + 24, inPtr + 36);
+		
+		char * outPtr = out + done / 3 * 4;
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(outPtr), encodeVector<Alphabet>(lo));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(outPtr + 32), encodeVector<Alphabet>(hi));
+		
+		done += 48;
+	}
+	
+	return done;
+}
+
+#else
+
+/**
+ * The compiler cannot target this instruction set, so the kernels never encode
+ * (or decode, or validate) anything and the dispatcher never selects them anyway.
+ */
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeAvx2(const byte *, char *, ulong)
+{
+	return 0;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeAvx2(const char *, byte *, ulong)
+{
+	return 0;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::validateAvx2(const char *, ulong)
+{
+	return 0;
+}
+
+#endif
+
+/**
+ * Compile the AVX2 kernels for every alphabet.
+ */
+template ulong BasicBase64<StandardAlphabet>::encodeAvx2(const byte *, char *, ulong);
+template ulong BasicBase64<StandardAlphabet>::decodeAvx2(const char *, byte *, ulong);
+template ulong BasicBase64<StandardAlphabet>::validateAvx2(const char *, ulong);
+template ulong BasicBase64<UrlAlphabet>::encodeAvx2(const byte *, char *, ulong);
+template ulong BasicBase64<UrlAlphabet>::decodeAvx2(const char *, byte *, ulong);
+template ulong BasicBase64<UrlAlphabet>::validateAvx2(const char *, ulong);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::encodeAvx2(const byte *, char *, ulong);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::decodeAvx2(const char *, byte *, ulong);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::validateAvx2(const char *, ulong);
@@ -0,0 +1,198 @@
+/**
+ *	File:		Base64Avx512.cpp
+ *	Author:		Alin Tomescu, tomescu.alin@gmail.com
+ *	Website:	http://alinush.org
+ *	Date: 		October 16th, 2026
+ *	License:	Free to use and distribute as long as this notice is kept.
+ */
+#include "Base64.h"
+
+#if defined(__AVX512VBMI__) && defined(__AVX512BW__)
+
+/**
+ * GCC's vpermb and vpermi2b intrinsics start from an undefined vector,
+ * which trips -Wmaybe-uninitialized when they get inlined.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include <immintrin.h>
+
+/**
+ * Masks selecting the 48 bytes that are encoded into (or decoded from) a 64-byte vector.
+ */
+static const __mmask64 blockMask = 0x0000FFFFFFFFFFFFULL;
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeAvx512(const byte * in, char * out, ulong inSize)
+{
+	/**
+	 * Spreads each 3-byte group over a 32-bit lane, as the bytes b1, b0, b2, b1.
+	 */
+	const __m512i spread = _mm512_setr_epi32(
+		0x01020001, 0x04050304, 0x07080607, 0x0A0B090A,
+		0x0D0E0C0D, 0x10110F10, 0x13141213, 0x16171516,
+		0x191A1819, 0x1C1D1B1C, 0x1F201E1F, 0x22232122,
+		0x25262425, 0x28292728, 0x2B2C2A2B, 0x2E2F2D2E);
+	
+	/**
+	 * The bit offsets, in every 64-bit lane, of the 6-bit numbers of its two groups.
+	 * vpmultishiftqb moves each of them into its own byte.
+	 */
+	const __m512i shifts = _mm512_set1_epi64(0x3036242A1016040AULL);
+	
+	/**
+	 * The whole alphabet fits in one vector, so vpermb translates all 64 numbers at once.
+	 */
+	const __m512i alphabet = _mm512_loadu_si512(_tables.byteToChar);
+	
+	/**
+	 * Each iteration encodes 48 bytes into 64 characters. The masked load
+	 * never reads past the 48 bytes, so there's no need for any slack.
+	 */
+	ulong done = 0;
+	
+	while(done + 48 <= inSize)
+	{
+		__m512i bytes = _mm512_maskz_loadu_epi8(blockMask, in + done);
+		
+		__m512i groups = _mm512_permutexvar_epi8(spread, bytes);
+		__m512i numbers = _mm512_multishift_epi64_epi8(shifts, groups);
+		__m512i chars = _mm512_permutexvar_epi8(numbers, alphabet);
+		
+		_mm512_storeu_si512(out + done / 3 * 4, chars);
+		
+		done += 48;
+	}
+	
+	return done;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeAvx512(const char * in, byte * out, ulong inSize)
+{
+	/**
+	 * The first 128 entries of the _tables.charToByte table fit in two vectors, so vpermi2b
+	 * translates all 64 characters at once. Characters outside the alphabet map to
+	 * values with the high bit set, and so do characters above 127, which vpermi2b
+	 * wraps around, so a single test on the high bits finds them all.
+	 */
+	const __m512i lookupLo = _mm512_loadu_si512(_tables.charToByte);
+	const __m512i lookupHi = _mm512_loadu_si512(_tables.charToByte + 64);
+	
+	/**
+	 * Puts the 3 bytes of every 24-bit group in big-endian order, one after the other.
+	 */
+	const __m512i pack = _mm512_setr_epi32(
+		0x06000102, 0x090A0405, 0x0C0D0E08, 0x16101112,
+		0x191A1415, 0x1C1D1E18, 0x26202122, 0x292A2425,
+		0x2C2D2E28, 0x36303132, 0x393A3435, 0x3C3D3E38,
+		0x00000000, 0x00000000, 0x00000000, 0x00000000);
+	
+	/**
+	 * Each iteration decodes 64 characters into 48 bytes. The last block of
+	 * the input might be padded, so it is always left to the scalar code.
+	 */
+	ulong done = 0;
+	
+	while(done + 68 <= inSize)
+	{
+		__m512i chars = _mm512_loadu_si512(in + done);
+		__m512i numbers = _mm512_permutex2var_epi8(lookupLo, chars, lookupHi);
+		
+		if(_mm512_movepi8_mask(_mm512_or_si512(numbers, chars)) != 0)
+			break;
+		
+		/**
+		 * Merge pairs of numbers into 12-bit values and then pairs of
+		 * those into 24-bit values, one in each 32-bit lane.
+		 */
+		__m512i pairs = _mm512_maddubs_epi16(numbers, _mm512_set1_epi32(0x01400140));
+		__m512i groups = _mm512_madd_epi16(pairs, _mm512_set1_epi32(0x00011000));
+		__m512i bytes = _mm512_permutexvar_epi8(pack, groups);
+		
+		_mm512_mask_storeu_epi8(out + done / 4 * 3, blockMask, bytes);
+		
+		done += 64;
+	}
+	
+	return done;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::validateAvx512(const char * in, ulong inSize)
+{
+	/**
+	 * The characters are looked up just like decodeAvx512 does it, and the high bits of
+	 * two vectors of them are tested at once.
+	 */
+	const __m512i lookupLo = _mm512_loadu_si512(_tables.charToByte);
+	const __m512i lookupHi = _mm512_loadu_si512(_tables.charToByte + 64);
+	
+	ulong done = 0;
+	
+	while(done + 128 <= inSize)
+	{
+		__m512i lo = _mm512_loadu_si512(in + done);
+		__m512i hi = _mm512_loadu_si512(in + done + 64);
+		__m512i invalid = _mm512_or_si512(
+			_mm512_or_si512(_mm512_permutex2var_epi8(lookupLo, lo, lookupHi), lo),
+			_mm512_or_si512(_mm512_permutex2var_epi8(lookupLo, hi, lookupHi), hi));
+		
+		if(_mm512_movepi8_mask(invalid) != 0)
+			break;
+		
+		done += 128;
+	}
+	
+	if(done + 64 <= inSize)
+	{
+		__m512i chars = _mm512_loadu_si512(in + done);
+		__m512i invalid = _mm512_or_si512(_mm512_permutex2var_epi8(lookupLo, chars, lookupHi), chars);
+		
+		if(_mm512_movepi8_mask(invalid) == 0)
+			done += 64;
+	}
+	
+	return done;
+}
+
+#else
+
+/**
+ * The compiler cannot target this instruction set, so the kernels never encode
+ * (or decode, or validate) anything and the dispatcher never selects them anyway.
+ */
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeAvx512(const byte *, char *, ulong)
+{
+	return 0;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeAvx512(const char *, byte *, ulong)
+{
+	return 0;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::validateAvx512(const char *, ulong)
+{
+	return 0;
+}
+
+#endif
+
+/**
+ * Compile the AVX-512 kernels for every alphabet.
+ */
+template ulong BasicBase64<StandardAlphabet>::encodeAvx512(const byte *, char *, ulong);
+template ulong BasicBase64<StandardAlphabet>::decodeAvx512(const char *, byte *, ulong);
+template ulong BasicBase64<StandardAlphabet>::validateAvx512(const char *, ulong);
+template ulong BasicBase64<UrlAlphabet>::encodeAvx512(const byte *, char *, ulong);
+template ulong BasicBase64<UrlAlphabet>::decodeAvx512(const char *, byte *, ulong);
+template ulong BasicBase64<UrlAlphabet>::validateAvx512(const char *, ulong);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::encodeAvx512(const byte *, char *, ulong);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::decodeAvx512(const char *, byte *, ulong);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::validateAvx512(const char *, ulong);
@@ -0,0 +1,279 @@
+/**
+ *	File:		Base64Batch.cpp
+ *	Author:		Alin Tomescu, tomescu.alin@gmail.com
+ *	Website:	http://alinush.org
+ *	Date: 		October 16th, 2026
+ *	License:	Free to use and distribute as long as this notice is kept.
+ */
+#include "Base64.h"
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::getEncodedBatchSize(std::span<const std::span<const std::byte>> inputs)
+{
+	ulong size = 0;
+	for(ulong i = 0; i < inputs.size(); i++)
+		size += getEncodedSize(inputs[i].size());
+
+	return size;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::getDecodedBatchSize(std::span<const std::string_view> inputs)
+{
+	ulong size = 0;
+	for(ulong i = 0; i < inputs.size(); i++)
+		size += getDecodedSize(inputs[i].data(), inputs[i].size());
+
+	return size;
+}
+
+/**
+ * Throws if the offsets array of a batch of the specified number of inputs is too small.
+ */
+static void checkBatchOffsets(ulong nInputs, ulong nOffsets)
+{
+	if(nOffsets < nInputs + 1)
+	{
+		std::ostringstream error;
+		error << "The offsets array (" << nOffsets << " entries) is too small for a batch of " << nInputs
+			<< " inputs, which needs " << nInputs + 1 << " entries.";
+		throw std::runtime_error(error.str());
+	}
+}
+
+/**
+ * Throws if the arena of a batch is too small.
+ */
+static void checkBatchArena(ulong arenaSize, ulong batchSize)
+{
+	if(arenaSize < batchSize)
+	{
+		std::ostringstream error;
+		error << "The arena (" << arenaSize << " bytes) is too small for the output of the batch (" << batchSize
+			<< " bytes).";
+		throw std::runtime_error(error.str());
+	}
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeBatch(std::span<const std::span<const std::byte>> inputs, std::span<char> arena,
+	std::span<ulong> offsets)
+{
+	/**
+	 * A batch counts as a single encodeBuffer call, not as the ones it makes.
+	 */
+	StatsScope stats(ENCODE_BUFFER);
+	
+	ulong nInputs = inputs.size();
+	checkBatchOffsets(nInputs, offsets.size());
+
+	ulong inSize = 0;
+	offsets[0] = 0;
+	for(ulong i = 0; i < nInputs; i++)
+	{
+		offsets[i + 1] = offsets[i] + getEncodedSize(inputs[i].size());
+		inSize += inputs[i].size();
+	}
+
+	stats.setBytesIn(inSize);
+
+	checkBatchArena(arena.size(), offsets[nInputs]);
+
+	/**
+	 * The inputs are gathered with their last block filled up with zeros, so that each one
+	 * starts on a block boundary. With padding, every encoding is then already at its offset
+	 * in the arena, and only needs its last block encoded again with padding. Without, the
+	 * encodings are shorter and get copied to their offsets from a staging buffer instead.
+	 */
+	byte staged[_batchBlockSize];
+	char stagedOut[_batchBlockSize / 3 * 4];
+	char * out = arena.data();
+	ulong i = 0;
+
+	while(i < nInputs)
+	{
+		if(inputs[i].size() > _batchBlockSize)
+		{
+			encodeBuffer(reinterpret_cast<const byte *>(inputs[i].data()), out + offsets[i], inputs[i].size());
+			i++;
+			continue;
+		}
+
+		ulong first = i;
+		ulong stagedSize = 0;
+
+		for(; i < nInputs && inputs[i].size() <= _batchBlockSize - stagedSize; i++)
+		{
+			ulong size = inputs[i].size();
+			if(size == 0)
+				continue;
+
+			memcpy(staged + stagedSize, inputs[i].data(), size);
+			stagedSize += size;
+
+			while(stagedSize % 3 != 0)
+				staged[stagedSize++] = 0;
+		}
+
+		char * groupOut = Alphabet::padding ? out + offsets[first] : stagedOut;
+		encodeBuffer(staged, groupOut, stagedSize);
+
+		for(ulong j = first; j < i; j++)
+		{
+			ulong size = inputs[j].size();
+			ulong lastSize = size % 3;
+			ulong fullLength = size / 3 * 4;
+
+			if(!Alphabet::padding)
+				memcpy(out + offsets[j], groupOut, fullLength);
+
+			if(lastSize > 0)
+				encodeBlock(reinterpret_cast<const byte *>(inputs[j].data()) + size - lastSize, out + offsets[j] + fullLength, lastSize);
+
+			groupOut += (size + 2) / 3 * 4;
+		}
+	}
+
+	return stats.finish(offsets[nInputs]);
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeBatch(std::span<const std::string_view> inputs, std::span<std::byte> arena,
+	std::span<ulong> offsets)
+{
+	/**
+	 * A batch counts as a single decodeBuffer call.
+	 */
+	StatsScope stats(DECODE_BUFFER);
+	
+	ulong nInputs = inputs.size();
+	checkBatchOffsets(nInputs, offsets.size());
+
+	ulong inSize = 0;
+	offsets[0] = 0;
+	for(ulong i = 0; i < nInputs; i++)
+	{
+		if(!isValidLength(inputs[i].size()))
+		{
+			stats.finish(DecodeResult { INVALID_LENGTH, inputs[i].size(), 0 });
+			throw batchError(i, invalidLengthError("base64-encoded line", inputs[i].size()));
+		}
+
+		offsets[i + 1] = offsets[i] + getDecodedSize(inputs[i].data(), inputs[i].size());
+		inSize += inputs[i].size();
+	}
+
+	stats.setBytesIn(inSize);
+	
+	if(arena.size() < offsets[nInputs])
+		stats.finish(DecodeResult { OUTPUT_TOO_SMALL, 0, offsets[nInputs] });
+	checkBatchArena(arena.size(), offsets[nInputs]);
+
+	/**
+	 * The inputs are gathered whole, each one starting on a block boundary, and decoded in one go
+	 * into a staging buffer. The padding of each input, or the characters missing from its partial
+	 * last block without padding, are replaced with 'A's, so they decode to bytes that are dropped
+	 * when the decoded data is copied to its offset in the arena. A padding character anywhere
+	 * else is left alone and caught as an invalid character.
+	 */
+	const ulong stagedCapacity = _batchBlockSize / 3 * 4;
+	char staged[stagedCapacity];
+	byte stagedOut[_batchBlockSize];
+	byte * out = reinterpret_cast<byte *>(arena.data());
+	ulong i = 0;
+
+	while(i < nInputs)
+	{
+		if(inputs[i].size() > stagedCapacity)
+		{
+			ulong decodedLength;
+			ulong errorOffset = decodeFused(inputs[i].data(), out + offsets[i], inputs[i].size(), decodedLength);
+
+			if(errorOffset != inputs[i].size())
+			{
+				stats.finish(DecodeResult { INVALID_CHARACTER, errorOffset, 0 });
+				throw batchError(i, invalidCharError(inputs[i][errorOffset], errorOffset));
+			}
+
+			i++;
+			continue;
+		}
+
+		ulong first = i;
+		ulong stagedSize = 0;
+
+		for(; i < nInputs && inputs[i].size() <= stagedCapacity - stagedSize; i++)
+		{
+			ulong size = inputs[i].size();
+			if(size == 0)
+				continue;
+
+			memcpy(staged + stagedSize, inputs[i].data(), size);
+			stagedSize += size;
+
+			while(stagedSize % 4 != 0)
+				staged[stagedSize++] = 'A';
+
+			if(Alphabet::padding && staged[stagedSize - 1] == _paddingChar)
+			{
+				if(staged[stagedSize - 2] == _paddingChar)
+					staged[stagedSize - 2] = 'A';
+				staged[stagedSize - 1] = 'A';
+			}
+		}
+
+		ulong decodedLength;
+		ulong errorOffset = decodeFused(staged, stagedOut, stagedSize, decodedLength);
+
+		if(errorOffset != stagedSize)
+		{
+			/**
+			 * Find the input the invalid character is in.
+			 */
+			ulong j = first;
+			ulong groupOffset = 0;
+			while(errorOffset >= groupOffset + (inputs[j].size() + 3) / 4 * 4)
+				groupOffset += (inputs[j++].size() + 3) / 4 * 4;
+
+			stats.finish(DecodeResult { INVALID_CHARACTER, errorOffset - groupOffset, 0 });
+			throw batchError(j, invalidCharError(staged[errorOffset], errorOffset - groupOffset));
+		}
+
+		const byte * groupOut = stagedOut;
+		for(ulong j = first; j < i; j++)
+		{
+			memcpy(out + offsets[j], groupOut, offsets[j + 1] - offsets[j]);
+			groupOut += (inputs[j].size() + 3) / 4 * 3;
+		}
+	}
+
+	return stats.finish(offsets[nInputs]);
+}
+
+template <class Alphabet>
+std::runtime_error BasicBase64<Alphabet>::batchError(ulong index, const std::runtime_error & error)
+{
+	std::ostringstream message;
+	message << "Input #" << index << " of the batch: " << error.what();
+	return std::runtime_error(message.str());
+}
+
+/**
+ * Compile the batch codecs for every alphabet.
+ */
+template ulong BasicBase64<StandardAlphabet>::getEncodedBatchSize(std::span<const std::span<const std::byte>>);
+template ulong BasicBase64<StandardAlphabet>::getDecodedBatchSize(std::span<const std::string_view>);
+template ulong BasicBase64<StandardAlphabet>::encodeBatch(std::span<const std::span<const std::byte>>, std::span<char>, std::span<ulong>);
+template ulong BasicBase64<StandardAlphabet>::decodeBatch(std::span<const std::string_view>, std::span<std::byte>, std::span<ulong>);
+template ulong BasicBase64<UrlAlphabet>::getEncodedBatchSize(std::span<const std::span<const std::byte>>);
+template ulong BasicBase64<UrlAlphabet>::getDecodedBatchSize(std::span<const std::string_view>);
+template ulong BasicBase64<UrlAlphabet>::encodeBatch(std::span<const std::span<const std::byte>>, std::span<char>, std::span<ulong>);
+template ulong BasicBase64<UrlAlphabet>::decodeBatch(std::span<const std::string_view>, std::span<std::byte>, std::span<ulong>);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::getEncodedBatchSize(std::span<const std::span<const std::byte>>);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::getDecodedBatchSize(std::span<const std::string_view>);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::encodeBatch(std::span<const std::span<const std::byte>>, std::span<char>, std::span<ulong>);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::decodeBatch(std::span<const std::string_view>, std::span<std::byte>, std::span<ulong>);
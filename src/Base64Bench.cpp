@@ -0,0 +1,310 @@
+/**
+ *	File:		Base64Bench.cpp
+ *	Author:		Alin Tomescu, tomescu.alin@gmail.com
+ *	Website:	http://alinush.org
+ *	Date: 		October 16th, 2026
+ *	License:	Free to use and distribute as long as this notice is kept.
+ */
+#include <iostream>
+#include <stdexcept>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <new>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "Base64.h"
+
+/**
+ * The cold measurements cycle through copies of their buffers that add up to this much
+ * memory, well past the size of the last-level cache, so every call starts out of the cache.
+ * Larger buffers get two copies, so that no call runs on the buffer the previous one touched.
+ */
+const ulong g_coldPoolSize = 128 << 20;
+
+/**
+ * The largest input size measured by default. Each size needs its plain, encoded and decoded
+ * buffers times the number of cold copies, so this keeps the run to a few hundred MB; larger
+ * sizes, up to 1 GB, can be asked for with --max-size.
+ */
+const ulong g_defaultMaxSize = 64 << 20;
+
+/**
+ * The results of the operations are added up here, so the compiler can't drop the calls.
+ */
+volatile ulong g_sink = 0;
+
+struct BenchOptions
+{
+	double minTime;
+	ulong minSize;
+	ulong maxSize;
+	const char * backend;
+	bool json;
+};
+
+/**
+ * One measurement of an operation on one backend. The throughput and the cycles are per byte
+ * of the operation's input: the plain data for encoding, the encoding for decoding and validating.
+ */
+struct BenchResult
+{
+	const char * backend;
+	const char * alphabet;
+	const char * operation;
+	ulong size;
+	bool cold;
+	ulong iterations;
+	double seconds;
+	double bytesPerSecond;
+	double cyclesPerByte;
+};
+
+/**
+ * Returns the time stamp counter, which ticks at a constant rate close to the nominal
+ * frequency of the CPU, or 0 where there is none.
+ */
+static ulong readCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+void printResult(const BenchResult & result, const BenchOptions & options, bool first)
+{
+	if(options.json)
+	{
+		printf("%s\n\t{ \"backend\": \"%s\", \"alphabet\": \"%s\", \"operation\": \"%s\", \"size\": %lu, \"cache\": \"%s\", "
+			"\"iterations\": %lu, \"seconds\": %.6f, \"gb_per_s\": %.4f, \"cycles_per_byte\": %.4f }",
+			first ? "" : ",", result.backend, result.alphabet, result.operation, result.size, result.cold ? "cold" : "hot",
+			result.iterations, result.seconds, result.bytesPerSecond / 1e9, result.cyclesPerByte);
+	}
+	else
+	{
+		printf("%s,%s,%s,%lu,%s,%lu,%.6f,%.4f,%.4f\n", result.backend, result.alphabet, result.operation, result.size,
+			result.cold ? "cold" : "hot", result.iterations, result.seconds, result.bytesPerSecond / 1e9, result.cyclesPerByte);
+	}
+
+	fflush(stdout);
+}
+
+/**
+ * Returns how much memory can be allocated without making the system swap, as reported by
+ * /proc/meminfo, or 0 where that's unknown.
+ */
+static ulong getAvailableMemory()
+{
+	std::ifstream meminfo("/proc/meminfo");
+	std::string line;
+
+	while(std::getline(meminfo, line))
+	{
+		ulong kilobytes;
+		if(sscanf(line.c_str(), "MemAvailable: %lu kB", &kilobytes) == 1)
+			return kilobytes << 10;
+	}
+
+	return 0;
+}
+
+/**
+ * Runs the operation over and over, on the first copy of its buffers when hot and on every
+ * copy in turn when cold, doubling the number of calls between clock reads until it ran
+ * for at least the minimum time.
+ *
+ * @param	operation	called with the index of the copy to run on
+ * @param	nCopies		the number of copies of the buffers
+ */
+template <class Operation>
+BenchResult measure(const Operation & operation, ulong nCopies, ulong inSize, bool cold, double minTime)
+{
+	BenchResult result = {};
+	result.cold = cold;
+
+	ulong sink = cold ? 0 : operation(0);
+	ulong cycles = 0;
+	ulong copy = 0;
+
+	for(ulong batch = 1; result.seconds < minTime; batch *= 2)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		ulong startCycles = readCycles();
+
+		for(ulong i = 0; i < batch; i++)
+		{
+			sink += operation(copy);
+			if(cold)
+				copy = copy + 1 < nCopies ? copy + 1 : 0;
+		}
+
+		cycles += readCycles() - startCycles;
+		result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		result.iterations += batch;
+	}
+
+	g_sink = g_sink + sink;
+
+	double bytes = static_cast<double>(inSize) * result.iterations;
+	result.bytesPerSecond = bytes / result.seconds;
+	result.cyclesPerByte = cycles / bytes;
+
+	return result;
+}
+
+/**
+ * Benchmarks encoding, decoding and validating with the specified codec on every supported
+ * backend, for input sizes from 8 bytes up, 8 times larger each time.
+ *
+ * @return	false if there was not enough memory for the largest sizes
+ */
+template <class Codec>
+bool benchmarkCodec(const char * alphabet, const BenchOptions & options, bool & first)
+{
+	for(ulong size = 8; size <= options.maxSize; size *= 8)
+	{
+		if(size < options.minSize)
+			continue;
+
+		ulong nCopies = size < g_coldPoolSize / 2 ? g_coldPoolSize / size : 2;
+		ulong encodedSize = Codec::getEncodedSize(size);
+		std::vector<byte> plain;
+		std::vector<char> encoded;
+		std::vector<byte> decoded;
+
+		/**
+		 * Allocations rarely fail outright where memory is overcommitted, the process gets
+		 * killed when it touches too much of it instead, so check what's available first.
+		 */
+		ulong available = getAvailableMemory();
+		if(available != 0 && (2 * size + encodedSize) * nCopies > available)
+		{
+			std::cerr << "Not enough memory to benchmark " << size << "-byte inputs, skipping the larger sizes." << std::endl;
+			return false;
+		}
+
+		try
+		{
+			plain.resize(size * nCopies);
+			encoded.resize(encodedSize * nCopies);
+			decoded.resize(size * nCopies);
+		}
+		catch(std::bad_alloc &)
+		{
+			std::cerr << "Not enough memory to benchmark " << size << "-byte inputs, skipping the larger sizes." << std::endl;
+			return false;
+		}
+
+		/**
+		 * The speed of the codecs doesn't depend on the data, so the same 64 KB of random
+		 * bytes are repeated over the larger inputs.
+		 */
+		for(ulong i = 0; i < size; i++)
+			plain[i] = i < 65536 ? static_cast<byte>(rand()) : plain[i - 65536];
+
+		for(ulong copy = 0; copy < nCopies; copy++)
+		{
+			if(copy > 0)
+				memcpy(&plain[copy * size], &plain[0], size);
+			Codec::encodeBuffer(&plain[copy * size], &encoded[copy * encodedSize], size);
+		}
+
+		for(int b = Base64::SCALAR; b < Base64::NUM_BACKENDS; b++)
+		{
+			Base64::Backend backend = static_cast<Base64::Backend>(b);
+			if(!Base64::isBackendSupported(backend) ||
+				(options.backend != NULL && strcmp(options.backend, Base64::getBackendName(backend)) != 0))
+				continue;
+
+			Base64::setBackend(backend);
+
+			for(int cold = 0; cold < 2; cold++)
+			{
+				BenchResult results[3];
+
+				results[0] = measure([&](ulong copy) {
+					return Codec::encodeBuffer(&plain[copy * size], &encoded[copy * encodedSize], size);
+				}, nCopies, size, cold, options.minTime);
+				results[0].operation = "encode";
+
+				results[1] = measure([&](ulong copy) {
+					return Codec::decodeBuffer(&encoded[copy * encodedSize], &decoded[copy * size], encodedSize);
+				}, nCopies, encodedSize, cold, options.minTime);
+				results[1].operation = "decode";
+
+				results[2] = measure([&](ulong copy) {
+					return Codec::validateEncoding(&encoded[copy * encodedSize], encodedSize).length;
+				}, nCopies, encodedSize, cold, options.minTime);
+				results[2].operation = "validate";
+
+				for(uint i = 0; i < 3; i++)
+				{
+					results[i].backend = Base64::getBackendName(backend);
+					results[i].alphabet = alphabet;
+					results[i].size = size;
+					printResult(results[i], options, first);
+					first = false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+int main(int argc, char ** argv)
+{
+	BenchOptions options = { 0.1, 0, g_defaultMaxSize, NULL, false };
+
+	for(int arg = 1; arg < argc; arg++)
+	{
+		if(strcmp(argv[arg], "--json") == 0)
+			options.json = true;
+		else if(strcmp(argv[arg], "--csv") == 0)
+			options.json = false;
+		else if(strcmp(argv[arg], "--min-time") == 0 && arg + 1 < argc)
+			options.minTime = atof(argv[++arg]);
+		else if(strcmp(argv[arg], "--min-size") == 0 && arg + 1 < argc)
+			options.minSize = strtoul(argv[++arg], NULL, 10);
+		else if(strcmp(argv[arg], "--max-size") == 0 && arg + 1 < argc)
+			options.maxSize = strtoul(argv[++arg], NULL, 10);
+		else if(strcmp(argv[arg], "--backend") == 0 && arg + 1 < argc)
+			options.backend = argv[++arg];
+		else
+		{
+			std::cout << argv[0] << " usage: " << std::endl;
+			std::cout << argv[0] << " [--csv | --json] [--min-time <seconds>] [--min-size <bytes>] [--max-size <bytes>] [--backend <name>]" << std::endl;
+			std::cout << std::endl;
+			std::cout << "  --csv        print the results as CSV (the default)" << std::endl;
+			std::cout << "  --json       print the results as a JSON array" << std::endl;
+			std::cout << "  --min-time   run each measurement for at least this long (0.1 seconds by default)" << std::endl;
+			std::cout << "  --min-size   skip the input sizes below this one" << std::endl;
+			std::cout << "  --max-size   skip the input sizes above this one (64 MB by default)" << std::endl;
+			std::cout << "  --backend    only measure the named backend (scalar, swar, ssse3, avx2 or avx512)" << std::endl;
+			return -1;
+		}
+	}
+
+	if(options.json)
+		printf("[");
+	else
+		printf("backend,alphabet,operation,size,cache,iterations,seconds,gb_per_s,cycles_per_byte\n");
+
+	bool first = true;
+	if(benchmarkCodec<Base64>("base64", options, first))
+		benchmarkCodec<Base64Url>("base64url", options, first);
+
+	if(options.json)
+		printf("\n]\n");
+
+	return 0;
+}
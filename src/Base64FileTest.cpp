@@ -0,0 +1,281 @@
+/**
+ *	File:		Base64FileTest.cpp
+ *	Author:		Alin Tomescu, tomescu.alin@gmail.com
+ *	Website:	http://alinush.org
+ *	Date: 		October 16th, 2026
+ *	License:	Free to use and distribute as long as this notice is kept.
+ */
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "Base64.h"
+
+/**
+ *	Paths of the temporary files used by the file tests.
+ */
+const char * g_plainFile = "base64-test-plain.tmp";
+const char * g_encodedFile = "base64-test-encoded.tmp";
+const char * g_decodedFile = "base64-test-decoded.tmp";
+
+std::string readFile(const char * path)
+{
+	std::ifstream fin(path, std::ios::binary);
+	std::ostringstream contents;
+	contents << fin.rdbuf();
+	return contents.str();
+}
+
+void writeFile(const char * path, const std::string& contents)
+{
+	std::ofstream fout(path, std::ios::binary);
+	fout.write(contents.c_str(), contents.length());
+}
+
+/**
+ *	Encodes the specified data as lines the way encodeFile should, using encodeBuffer.
+ */
+std::string encodeLines(const std::string& data, const char * newline, uint lineSize)
+{
+	std::string result;
+	uint inLineSize = lineSize / 4 * 3;
+	std::vector<char> buffer(lineSize);
+	
+	for(ulong done = 0; done < data.length(); done += inLineSize)
+	{
+		ulong size = std::min<ulong>(inLineSize, data.length() - done);
+		ulong length = Base64::encodeBuffer(reinterpret_cast<const byte *>(data.c_str()) + done, &buffer[0], size);
+		result.append(&buffer[0], length);
+		result += newline;
+	}
+	
+	return result;
+}
+
+/**
+ *	Splits the specified encoding into lines of the specified size, the way `base64 -w` does.
+ */
+std::string wrapLines(const std::string& encoded, ulong lineSize, const char * newline)
+{
+	std::string result;
+	for(ulong done = 0; done < encoded.length(); done += lineSize)
+		result += encoded.substr(done, lineSize) + newline;
+	
+	return result;
+}
+
+void testFiles()
+{
+	const ulong sizes[] = { 1, 2, 3, 56, 57, 58, 1000, 123457, 5000003, 20000000 };
+	const uint lineSizes[] = { 4, 64, 76, 1000 };
+	const char * newlines[] = { "\r\n", "\n" };
+	
+	for(uint i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++)
+	{
+		std::string data(sizes[i], '\0');
+		for(ulong j = 0; j < data.length(); j++)
+			data[j] = static_cast<char>(rand());
+		
+		writeFile(g_plainFile, data);
+		
+		for(uint l = 0; l < sizeof(lineSizes)/sizeof(lineSizes[0]); l++)
+		{
+			for(uint n = 0; n < sizeof(newlines)/sizeof(newlines[0]); n++)
+			{
+				std::ostringstream testName;
+				testName << "Base64 file test failed for a " << sizes[i] << "-byte file with " << lineSizes[l] << "-character lines: ";
+				
+				Base64::encodeFile(g_plainFile, g_encodedFile, newlines[n], lineSizes[l]);
+				if(readFile(g_encodedFile) != encodeLines(data, newlines[n], lineSizes[l]))
+					throw std::runtime_error(testName.str() + "Encoding the file gave an unexpected result.");
+				
+				Base64::decodeFile(g_encodedFile, g_decodedFile);
+				if(readFile(g_decodedFile) != data)
+					throw std::runtime_error(testName.str() + "Decoding the encoded file did not give back the original file.");
+				
+				Base64::encodeFileMapped(g_plainFile, g_encodedFile, newlines[n], lineSizes[l]);
+				if(readFile(g_encodedFile) != encodeLines(data, newlines[n], lineSizes[l]))
+					throw std::runtime_error(testName.str() + "Encoding the mapped file gave an unexpected result.");
+				
+				Base64::encodeFile(g_plainFile, g_encodedFile, newlines[n], lineSizes[l], 4);
+				if(readFile(g_encodedFile) != encodeLines(data, newlines[n], lineSizes[l]))
+					throw std::runtime_error(testName.str() + "Encoding the file on 4 threads gave an unexpected result.");
+				
+				Base64::decodeFileMapped(g_encodedFile, g_decodedFile);
+				if(readFile(g_decodedFile) != data)
+					throw std::runtime_error(testName.str() + "Decoding the mapped encoded file did not give back the original file.");
+				
+				Base64::decodeFile(g_encodedFile, g_decodedFile, 4);
+				if(readFile(g_decodedFile) != data)
+					throw std::runtime_error(testName.str() + "Decoding the encoded file on 4 threads did not give back the original file.");
+			}
+		}
+	}
+	
+	remove(g_plainFile);
+	remove(g_encodedFile);
+	remove(g_decodedFile);
+}
+
+/**
+ *	Returns the message of the exception thrown by decoding the specified file on the specified number of threads,
+ *	through memory mappings if mapped is true.
+ */
+std::string getDecodeFileError(const char * path, uint nThreads, bool mapped = false)
+{
+	try
+	{
+		if(mapped)
+			Base64::decodeFileMapped(path, g_decodedFile, nThreads);
+		else
+			Base64::decodeFile(path, g_decodedFile, nThreads);
+	}
+	catch(std::runtime_error& e)
+	{
+		return e.what();
+	}
+	
+	return "";
+}
+
+void testFileErrors()
+{
+	//	Errors must be reported on the right line, even when they're far into the file and it's decoded in parallel:
+	//	an encoding that ends in padding on a line where its size is not a multiple of 4, which the next line
+	//	could still complete and so is reported there, and a truncated last line
+	const uint nLines = 200000;
+	const uint badLine = 150000;
+	std::string line(76, 'A');
+	
+	const uint badLines[] = { badLine, nLines };
+	for(uint j = 0; j < sizeof(badLines)/sizeof(badLines[0]); j++)
+	{
+		std::string encoded;
+		for(uint i = 1; i <= nLines; i++)
+			encoded += (i == badLines[j] ? line.substr(2) + (i < nLines ? "=" : "") : line) + "\r\n";
+		writeFile(g_encodedFile, encoded);
+		
+		std::ostringstream expected;
+		expected << "Line #" << (badLines[j] < nLines ? badLines[j] + 1 : badLines[j]) << " ";
+		
+		for(uint nThreads = 1; nThreads <= 4; nThreads *= 4)
+		{
+			std::string error = getDecodeFileError(g_encodedFile, nThreads);
+			if(error.find(expected.str()) == std::string::npos)
+				throw std::runtime_error("Base64 file errors test failed: Expected an error on \"" + expected.str() + "\" but got \"" + error + "\" instead.");
+		}
+	}
+	
+	//	Invalid characters on two different lines: the earlier one must be reported
+	std::ostringstream expected;
+	expected << "Line #" << badLine << " ";
+	
+	std::string encoded;
+	for(uint i = 1; i <= nLines; i++)
+		encoded += (i == badLine ? "A*" + line.substr(2) : i == nLines ? "*" + line.substr(1) : line) + "\n";
+	writeFile(g_encodedFile, encoded);
+	
+	std::string error = getDecodeFileError(g_encodedFile, 4);
+	if(error.find(expected.str()) == std::string::npos)
+		throw std::runtime_error("Base64 file errors test failed: Expected an error on \"" + expected.str() + "\" but got \"" + error + "\" instead.");
+	
+	//	Data after padding, in a block that a 4 MB chunk of the parallel and mapped decoders splits right after the padding
+	const ulong blockSize = 4 << 20;
+	writeFile(g_encodedFile, std::string(blockSize - 2, 'A') + "==H\nAAA\n");
+	
+	const std::pair<uint, bool> decoders[] = { { 1, false }, { 4, false }, { 1, true } };
+	for(uint i = 0; i < sizeof(decoders)/sizeof(decoders[0]); i++)
+	{
+		error = getDecodeFileError(g_encodedFile, decoders[i].first, decoders[i].second);
+		if(error.find("Line #2 ") == std::string::npos || error.find("data found after padding") == std::string::npos)
+			throw std::runtime_error("Base64 file errors test failed: Expected data found after padding on \"Line #2 \" but got \"" + error + "\" instead.");
+	}
+	
+	remove(g_encodedFile);
+	remove(g_decodedFile);
+}
+
+void testFileLayouts()
+{
+	//	Lines of any size, including a single unwrapped line, with \n and \r\n newlines mixed in any way,
+	//	and lines that split the 4-character blocks of the encoding anywhere
+	std::string data(10000000, '\0');
+	for(ulong i = 0; i < data.length(); i++)
+		data[i] = static_cast<char>(rand());
+	
+	std::string line(Base64::getEncodedSize(data.length()), '\0');
+	Base64::encodeBuffer(reinterpret_cast<const byte *>(data.c_str()), &line[0], data.length());
+	
+	std::vector<std::string> layouts;
+	layouts.push_back(line);
+	layouts.push_back(line + "\n");
+	layouts.push_back(line + "\r\n\r\n\n");
+	
+	//	What `base64 -w 70` and `base64 -w 57` produce
+	layouts.push_back(wrapLines(line, 70, "\n"));
+	layouts.push_back(wrapLines(line, 57, "\r\n"));
+	
+	//	Padding split across two lines, at the end of the file and after a separately encoded
+	//	piece, like `base64 -w 67` of the data and `base64 -w 71` of its first 52 bytes produce
+	layouts.push_back(wrapLines(line, 67, "\n"));
+	
+	std::span<const char> bytes(data);
+	layouts.push_back(wrapLines(Base64::encode(std::as_bytes(bytes.first(52))), 71, "\n")
+		+ wrapLines(Base64::encode(std::as_bytes(bytes.subspan(52))), 76, "\n"));
+	
+	//	Random line sizes, multiples of 4 and not, and newlines
+	const uint multiples[] = { 4, 1 };
+	for(uint m = 0; m < sizeof(multiples)/sizeof(multiples[0]); m++)
+	{
+		std::string encoded = "\n";
+		for(ulong done = 0; done < line.length(); )
+		{
+			ulong size = std::min<ulong>(line.length() - done, multiples[m] * (rand() % 50000));
+			encoded += line.substr(done, size) + (rand() % 2 ? "\r\n" : "\n");
+			done += size;
+		}
+		layouts.push_back(encoded);
+	}
+	
+	//	Pieces of the data encoded separately, with their padding, and wrapped at 70 characters
+	std::string encoded;
+	for(ulong done = 0; done < data.length(); )
+	{
+		ulong size = std::min<ulong>(data.length() - done, 1 + rand() % 300000);
+		encoded += wrapLines(Base64::encode(std::as_bytes(std::span<const char>(data).subspan(done, size))), 70, "\n");
+		done += size;
+	}
+	layouts.push_back(encoded);
+	
+	//	A \r\n split between two of decodeFile's 4 MB blocks
+	const ulong blockSize = 4 << 20;
+	encoded = "\n\n\n" + line.substr(0, blockSize - 4) + "\r\n" + line.substr(blockSize - 4);
+	layouts.push_back(encoded);
+	
+	for(uint i = 0; i < layouts.size(); i++)
+	{
+		writeFile(g_encodedFile, layouts[i]);
+		
+		for(uint nThreads = 1; nThreads <= 4; nThreads *= 4)
+		{
+			Base64::decodeFile(g_encodedFile, g_decodedFile, nThreads);
+			if(readFile(g_decodedFile) != data)
+			{
+				std::ostringstream error;
+				error << "Base64 file layouts test failed: Decoding layout #" << i + 1 << " on " << nThreads
+					<< " thread(s) did not give back the original data.";
+				throw std::runtime_error(error.str());
+			}
+		}
+	}
+	
+	remove(g_encodedFile);
+	remove(g_decodedFile);
+}
@@ -0,0 +1,472 @@
+/**
+ *	File:		Base64Mapped.cpp
+ *	Author:		Alin Tomescu, tomescu.alin@gmail.com
+ *	Website:	http://alinush.org
+ *	Date: 		October 16th, 2026
+ *	License:	Free to use and distribute as long as this notice is kept.
+ */
+#include "Base64.h"
+#include "ThreadPool.h"
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * An open file and the mapping of its contents, both released when it goes out of scope.
+ */
+struct MappedFile
+{
+	int fd;
+	byte * data;
+	ulong size;
+	
+	MappedFile() : fd(-1), data(NULL), size(0) {}
+	
+	~MappedFile()
+	{
+		unmap();
+		if(fd >= 0)
+			close(fd);
+	}
+	
+	void unmap()
+	{
+		if(data != NULL)
+			munmap(data, size);
+		data = NULL;
+	}
+};
+
+/**
+ * Throws an exception describing the last I/O error.
+ */
+static void throwIoError(const char * message, const char * path)
+{
+	std::ostringstream error;
+	error << message << path << " (" << strerror(errno) << ")";
+	throw std::runtime_error(error.str());
+}
+
+/**
+ * Opens and maps the specified input file for reading, sequentially.
+ *
+ * @throws	std::runtime_error	if there's an I/O error or if the file is empty
+ */
+static void mapInputFile(MappedFile & file, const char * path, const char * emptyMessage)
+{
+	file.fd = open(path, O_RDONLY);
+	if(file.fd < 0)
+		throwIoError("Cannot open input file for reading: ", path);
+	
+	struct stat info;
+	if(fstat(file.fd, &info) != 0)
+		throwIoError("Cannot get the size of input file: ", path);
+	
+	file.size = info.st_size;
+	if(file.size == 0)
+	{
+		std::ostringstream error;
+		error << emptyMessage << path;
+		throw std::runtime_error(error.str());
+	}
+	
+	void * data = mmap(NULL, file.size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+	if(data == MAP_FAILED)
+		throwIoError("Cannot map input file: ", path);
+	
+	file.data = static_cast<byte *>(data);
+	madvise(file.data, file.size, MADV_SEQUENTIAL);
+}
+
+/**
+ * Creates the specified output file with the specified size, reserving its blocks up front
+ * so that running out of space shows up here rather than as a SIGBUS while writing to the
+ * mapping, and maps it for writing, sequentially.
+ *
+ * @throws	std::runtime_error	if there's an I/O error
+ */
+static void mapOutputFile(MappedFile & file, const char * path, ulong size)
+{
+	file.fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(file.fd < 0)
+		throwIoError("Cannot open output file for writing: ", path);
+	
+	if(size == 0)
+		return;
+	
+	/**
+	 * Some file systems can't reserve blocks, in which case the file is just resized.
+	 */
+	int result = posix_fallocate(file.fd, 0, size);
+	if(result == EINVAL || result == EOPNOTSUPP)
+		result = ftruncate(file.fd, size) == 0 ? 0 : errno;
+	
+	if(result != 0)
+	{
+		errno = result;
+		throwIoError("Cannot allocate space for output file: ", path);
+	}
+	
+	void * data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file.fd, 0);
+	if(data == MAP_FAILED)
+		throwIoError("Cannot map output file: ", path);
+	
+	file.data = static_cast<byte *>(data);
+	file.size = size;
+	madvise(file.data, file.size, MADV_SEQUENTIAL);
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::getEncodedFileSize(ulong inputSize, const char * newline, uint lineSize)
+{
+	ulong inLineSize = lineSize / 4 * 3;
+	ulong nLines = (inputSize + inLineSize - 1) / inLineSize;
+	
+	return getEncodedSize(inputSize) + nLines * strlen(newline);
+}
+
+template <class Alphabet>
+void BasicBase64<Alphabet>::encodeFileMapped(const char * inFile, const char * outFile, const char * newline, uint lineSize,
+	uint nThreads)
+{
+	StatsScope stats(ENCODE_FILE);
+	
+	if(lineSize % 4 || lineSize == 0)
+	{
+		std::ostringstream error;
+		error << "The output file line size must be a positive multiple of 4. You provided " << lineSize << ".";
+		throw std::runtime_error(error.str());
+	}
+	
+	MappedFile fin, fout;
+	mapInputFile(fin, inFile, "Cannot base64 encode an empty file: ");
+	
+	/**
+	 * The encoded size is known up front, so the output file can be created with
+	 * its final size and encoded into straight from the input mapping.
+	 */
+	ulong outSize = getEncodedFileSize(fin.size, newline, lineSize);
+	mapOutputFile(fout, outFile, outSize);
+	
+	stats.setBytesIn(fin.size);
+	stats.setBytesOut(outSize);
+	
+	/**
+	 * Split the input into chunks of whole lines, so that each chunk's output starts at a
+	 * known offset, and let the threads encode them. Only the last chunk can end in a
+	 * partial line.
+	 */
+	ulong inLineSize = lineSize / 4 * 3;
+	ulong outLineSize = lineSize + strlen(newline);
+	ulong linesPerChunk = _fileBlockSize / inLineSize > 0 ? _fileBlockSize / inLineSize : 1;
+	ulong inChunkSize = linesPerChunk * inLineSize;
+	ulong nChunks = (fin.size + inChunkSize - 1) / inChunkSize;
+	
+	ThreadPool::parallelFor(nChunks, nThreads, [&](ulong chunk)
+	{
+		StatsScope worker(NUM_OPERATIONS);
+		ulong offset = chunk * inChunkSize;
+		ulong size = fin.size - offset < inChunkSize ? fin.size - offset : inChunkSize;
+		char * out = reinterpret_cast<char *>(fout.data) + chunk * linesPerChunk * outLineSize;
+		
+		encodeLines(fin.data + offset, out, size, newline, lineSize);
+	});
+}
+
+/**
+ * A line of a base64-encoded file that ends in padding, and so completes an encoding if it also
+ * completes a block: the number of characters up to the end of it in its chunk and the number of
+ * padding characters it ends in.
+ */
+struct PaddedLine
+{
+	ulong nChars;
+	uint nPadding;
+};
+
+/**
+ * A chunk of whole lines of a base64-encoded file, decoded independently of the others.
+ */
+struct DecodeChunk
+{
+	const char * begin;
+	const char * end;
+	
+	/**
+	 * Filled in by the first pass: the number of lines in the chunk, the number (in the chunk,
+	 * starting at 1) of its last line with any characters (0 if none), the number of characters
+	 * in its lines and its lines that end in padding.
+	 */
+	ulong nLines;
+	ulong lastDataLine;
+	ulong nChars;
+	std::vector<PaddedLine> paddedLines;
+	
+	/**
+	 * Filled in from the prefix sums of the above: the number of lines before the chunk, the
+	 * number of characters of the encoding it starts in that come before it, and where its
+	 * decoded data starts and ends in the output file.
+	 */
+	ulong lineBase;
+	ulong segmentOffset;
+	ulong outOffset;
+	ulong outEnd;
+	
+	/**
+	 * The error the second pass ran into while decoding the chunk, if any.
+	 */
+	std::string error;
+};
+
+/**
+ * Calls visit(line, lineSize) for every line between begin and end, with the \r of \r\n
+ * terminated lines stripped away. There is no empty line after a final newline.
+ */
+template <class Visitor>
+static void forEachLine(const char * begin, const char * end, Visitor visit)
+{
+	while(begin < end)
+	{
+		const char * lineEnd = static_cast<const char *>(memchr(begin, '\n', end - begin));
+		if(lineEnd == NULL)
+			lineEnd = end;
+		
+		ulong lineSize = lineEnd - begin;
+		if(lineSize > 0 && begin[lineSize - 1] == '\r')
+			lineSize--;
+		
+		visit(begin, lineSize);
+		begin = lineEnd + 1;
+	}
+}
+
+/**
+ * Looks for the last n characters of the lines of the file between begin and end that come
+ * before pos, skipping the newlines the way forEachLine does, and stores them, in order, at
+ * the end of the n characters at chars.
+ *
+ * @return	the number of characters found, which is less than n if the file starts too soon
+ */
+static ulong getPreviousChars(const char * begin, const char * end, const char * pos, char * chars, ulong n)
+{
+	ulong count = 0;
+	
+	while(count < n && pos > begin)
+	{
+		pos--;
+		
+		bool newline = *pos == '\n' || (*pos == '\r' && pos + 1 < end && pos[1] == '\n');
+		if(!newline)
+			chars[n - ++count] = *pos;
+	}
+	
+	return count;
+}
+
+template <class Alphabet>
+void BasicBase64<Alphabet>::decodeFileMapped(const char * inFile, const char * outFile, uint nThreads)
+{
+	StatsScope stats(DECODE_FILE);
+	
+	MappedFile fin, fout;
+	mapInputFile(fin, inFile, "Cannot base64 decode an empty file: ");
+	stats.setBytesIn(fin.size);
+	
+	/**
+	 * Split the input into chunks of roughly _fileBlockSize bytes, each one ending
+	 * right after a newline (or at the end of the file), so that no line is split.
+	 */
+	const char * inBegin = reinterpret_cast<const char *>(fin.data);
+	const char * inEnd = inBegin + fin.size;
+	std::vector<DecodeChunk> chunks;
+	
+	for(const char * begin = inBegin; begin < inEnd; )
+	{
+		const char * end = inEnd;
+		if(static_cast<ulong>(inEnd - begin) > _fileBlockSize)
+		{
+			end = static_cast<const char *>(memchr(begin + _fileBlockSize, '\n', inEnd - begin - _fileBlockSize));
+			end = end != NULL ? end + 1 : inEnd;
+		}
+		
+		DecodeChunk chunk = DecodeChunk();
+		chunk.begin = begin;
+		chunk.end = end;
+		chunks.push_back(chunk);
+		
+		begin = end;
+	}
+	
+	/**
+	 * First pass: count the lines and characters in each chunk and find the lines that end
+	 * in padding, which is all it takes to work out how many bytes the chunks decode to.
+	 */
+	ThreadPool::parallelFor(chunks.size(), nThreads, [&](ulong i)
+	{
+		DecodeChunk & chunk = chunks[i];
+		
+		forEachLine(chunk.begin, chunk.end, [&](const char * line, ulong lineSize)
+		{
+			chunk.nLines++;
+			if(lineSize == 0)
+				return;
+			
+			chunk.nChars += lineSize;
+			chunk.lastDataLine = chunk.nLines;
+			
+			if(Alphabet::padding && line[lineSize - 1] == _paddingChar)
+			{
+				char previous;
+				bool twice = getPreviousChars(inBegin, inEnd, line + lineSize - 1, &previous, 1) == 1 && previous == _paddingChar;
+				chunk.paddedLines.push_back(PaddedLine { chunk.nChars, twice ? 2u : 1u });
+			}
+		});
+	});
+	
+	/**
+	 * The prefix sums give the number of each chunk's first line, how far into an encoding
+	 * it starts, and where it goes in the output. An encoding decodes to 3 bytes for every
+	 * block but its last one, which only the encoding's size and padding are needed for.
+	 * A padded line only ends its encoding if it completes a block, as the rest of the
+	 * padding may be on the next line.
+	 */
+	ulong nLines = 0, lastDataLine = 0, segmentChars = 0, outSize = 0;
+	for(ulong i = 0; i < chunks.size(); i++)
+	{
+		DecodeChunk & chunk = chunks[i];
+		chunk.lineBase = nLines;
+		chunk.segmentOffset = segmentChars;
+		chunk.outOffset = outSize + segmentChars / 4 * 3;
+		
+		ulong chars = 0;
+		for(const PaddedLine & padded : chunk.paddedLines)
+		{
+			ulong segmentSize = segmentChars + padded.nChars - chars;
+			if(segmentSize % 4 != 0)
+				continue;
+			
+			outSize += segmentSize / 4 * 3 - padded.nPadding;
+			segmentChars = 0;
+			chars = padded.nChars;
+		}
+		
+		segmentChars += chunk.nChars - chars;
+		if(chunk.lastDataLine != 0)
+			lastDataLine = nLines + chunk.lastDataLine;
+		nLines += chunk.nLines;
+	}
+	
+	outSize += getDecodedSize(segmentChars);
+	for(ulong i = 0; i < chunks.size(); i++)
+		chunks[i].outEnd = i + 1 < chunks.size() ? chunks[i + 1].outOffset : outSize;
+	
+	/**
+	 * Second pass: decode the chunks straight into the output file, which now has its exact size.
+	 * Errors are recorded rather than thrown, so that the one on the earliest line gets reported.
+	 */
+	mapOutputFile(fout, outFile, outSize);
+	stats.setBytesOut(outSize);
+	
+	ThreadPool::parallelFor(chunks.size(), nThreads, [&](ulong i)
+	{
+		StatsScope worker(NUM_OPERATIONS);
+		DecodeChunk & chunk = chunks[i];
+		byte * out = fout.data + chunk.outOffset;
+		byte * outEnd = fout.data + chunk.outEnd;
+		ulong lineNumber = chunk.lineBase;
+		
+		/**
+		 * The decoder writes to a buffer, which is copied to the chunk's part of the output file.
+		 * Only invalid data can decode to more than fits, and it gets reported anyway.
+		 */
+		Decoder decoder;
+		byte buffer[_mappedStageSize / 4 * 3 + 3];
+		
+		auto write = [&](ulong size)
+		{
+			if(size > static_cast<ulong>(outEnd - out))
+				size = outEnd - out;
+			
+			memcpy(out, buffer, size);
+			out += size;
+		};
+		
+		auto decode = [&](const char * in, ulong inSize)
+		{
+			for(ulong done = 0; done < inSize; done += _mappedStageSize)
+			{
+				ulong size = inSize - done < _mappedStageSize ? inSize - done : _mappedStageSize;
+				write(decoder.update(in + done, buffer, size));
+			}
+		};
+		
+		try
+		{
+			/**
+			 * Pick up the characters of the block the previous chunk split, as if
+			 * the decoder had already decoded the rest of the encoding before them.
+			 * The character before them ends the last block it decoded, and tells
+			 * whether that block was padded, which no data may come after.
+			 */
+			char previous[4];
+			ulong nPending = chunk.segmentOffset % 4;
+			ulong nPrevious = chunk.segmentOffset > nPending ? nPending + 1 : nPending;
+			getPreviousChars(inBegin, inEnd, chunk.begin, previous, nPrevious);
+			
+			bool padded = nPrevious > nPending && previous[0] == _paddingChar;
+			decoder.resume(chunk.segmentOffset, padded, previous + nPrevious - nPending);
+			
+			forEachLine(chunk.begin, chunk.end, [&](const char * line, ulong lineSize)
+			{
+				lineNumber++;
+				decode(line, lineSize);
+				
+				if(Alphabet::padding && lineSize > 0 && line[lineSize - 1] == _paddingChar && decoder.atBlockBoundary())
+					write(decoder.finish(buffer));
+			});
+			
+			/**
+			 * Like decodeFile, blame a truncated encoding on the last line with any data.
+			 */
+			if(i + 1 == chunks.size())
+			{
+				lineNumber = lastDataLine;
+				write(decoder.finish(buffer));
+			}
+		}
+		catch(std::runtime_error & e)
+		{
+			std::ostringstream error;
+			error << "Line #" << lineNumber << " in input file \"" << inFile << "\": " << e.what();
+			chunk.error = error.str();
+		}
+	});
+	
+	for(ulong i = 0; i < chunks.size(); i++)
+	{
+		if(!chunks[i].error.empty())
+			throw std::runtime_error(chunks[i].error);
+	}
+}
+
+/**
+ * Compile the mapped file methods for every alphabet.
+ */
+template ulong BasicBase64<StandardAlphabet>::getEncodedFileSize(ulong, const char *, uint);
+template void BasicBase64<StandardAlphabet>::encodeFileMapped(const char *, const char *, const char *, uint, uint);
+template void BasicBase64<StandardAlphabet>::decodeFileMapped(const char *, const char *, uint);
+template ulong BasicBase64<UrlAlphabet>::getEncodedFileSize(ulong, const char *, uint);
+template void BasicBase64<UrlAlphabet>::encodeFileMapped(const char *, const char *, const char *, uint, uint);
+template void BasicBase64<UrlAlphabet>::decodeFileMapped(const char *, const char *, uint);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::getEncodedFileSize(ulong, const char *, uint);
+template void BasicBase64<UrlUnpaddedAlphabet>::encodeFileMapped(const char *, const char *, const char *, uint, uint);
+template void BasicBase64<UrlUnpaddedAlphabet>::decodeFileMapped(const char *, const char *, uint);
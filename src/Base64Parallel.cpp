@@ -0,0 +1,103 @@
+/**
+ *	File:		Base64Parallel.cpp
+ *	Author:		Alin Tomescu, tomescu.alin@gmail.com
+ *	Website:	http://alinush.org
+ *	Date: 		October 16th, 2026
+ *	License:	Free to use and distribute as long as this notice is kept.
+ */
+#include "Base64.h"
+#include "ThreadPool.h"
+
+#include <vector>
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeBuffer(const byte * in, char * out, ulong inSize, uint nThreads)
+{
+	StatsScope stats(ENCODE_BUFFER, inSize);
+	
+	if(nThreads <= 1 || inSize < _parallelMinSize)
+		return stats.finish(encodeBuffer(in, out, inSize));
+	
+	/**
+	 * Every chunk but the last one is a whole number of 3-byte blocks, so its encoding
+	 * has no padding and starts right where the previous one ends.
+	 */
+	ulong nChunks = (inSize + _parallelChunkSize - 1) / _parallelChunkSize;
+	
+	ThreadPool::parallelFor(nChunks, nThreads, [&](ulong chunk)
+	{
+		StatsScope worker(NUM_OPERATIONS);
+		ulong offset = chunk * _parallelChunkSize;
+		ulong size = inSize - offset < _parallelChunkSize ? inSize - offset : _parallelChunkSize;
+		
+		encodeBuffer(in + offset, out + offset / 3 * 4, size);
+	});
+	
+	return stats.finish(getEncodedSize(inSize));
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeBuffer(const char * in, byte * out, ulong inSize, uint nThreads)
+{
+	StatsScope stats(DECODE_BUFFER, inSize);
+	
+	if(nThreads <= 1 || inSize < _parallelMinSize)
+	{
+		DecodeResult result = stats.finish(tryDecodeBuffer(in, out, inSize));
+		if(result.error != DECODE_OK)
+			throw decodeError(result, in);
+		
+		return result.length;
+	}
+	
+	if(!isValidLength(inSize))
+		throw decodeError(stats.finish(DecodeResult { INVALID_LENGTH, inSize, 0 }), in);
+	
+	/**
+	 * Every chunk but the last one is a whole number of 4-character blocks, which can't
+	 * have padding, so its decoding starts right where the previous one ends.
+	 */
+	const ulong chunkSize = _parallelChunkSize / 3 * 4;
+	ulong nChunks = (inSize + chunkSize - 1) / chunkSize;
+	std::vector<DecodeResult> results(nChunks);
+	
+	ThreadPool::parallelFor(nChunks, nThreads, [&](ulong chunk)
+	{
+		StatsScope worker(NUM_OPERATIONS);
+		ulong offset = chunk * chunkSize;
+		ulong size = inSize - offset < chunkSize ? inSize - offset : chunkSize;
+		
+		const char * chunkIn = in + offset;
+		results[chunk] = tryDecodeBuffer(chunkIn, out + offset / 4 * 3, size);
+		
+		/**
+		 * What looks like padding at the end of a chunk is in the middle of the input.
+		 */
+		if(results[chunk].error == DECODE_OK && offset + size < inSize && Alphabet::padding &&
+			chunkIn[size - 1] == _paddingChar)
+			results[chunk] = DecodeResult { INVALID_CHARACTER, chunkIn[size - 2] == _paddingChar ? size - 2 : size - 1, 0 };
+		
+		results[chunk].offset += offset;
+	});
+	
+	/**
+	 * Report the error in the earliest chunk, which is the one decodeBuffer would run into first.
+	 */
+	for(ulong chunk = 0; chunk < nChunks; chunk++)
+	{
+		if(results[chunk].error != DECODE_OK)
+			throw decodeError(stats.finish(results[chunk]), in);
+	}
+	
+	return stats.finish((nChunks - 1) * _parallelChunkSize + results[nChunks - 1].length);
+}
+
+/**
+ * Compile the parallel codecs for every alphabet.
+ */
+template ulong BasicBase64<StandardAlphabet>::encodeBuffer(const byte *, char *, ulong, uint);
+template ulong BasicBase64<StandardAlphabet>::decodeBuffer(const char *, byte *, ulong, uint);
+template ulong BasicBase64<UrlAlphabet>::encodeBuffer(const byte *, char *, ulong, uint);
+template ulong BasicBase64<UrlAlphabet>::decodeBuffer(const char *, byte *, ulong, uint);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::encodeBuffer(const byte *, char *, ulong, uint);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::decodeBuffer(const char *, byte *, ulong, uint);
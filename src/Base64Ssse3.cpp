@@ -0,0 +1,235 @@
+/**
+ *	File:		Base64Ssse3.cpp
+ *	Author:		Alin Tomescu, tomescu.alin@gmail.com
+ *	Website:	http://alinush.org
+ *	Date: 		October 16th, 2026
+ *	License:	Free to use and distribute as long as this notice is kept.
+ */
+#include "Base64.h"
+
+#if defined(__SSSE3__)
+
+#include <tmmintrin.h>
+#include <stdint.h>
+
+/**
+ * Encodes the 12 bytes at the beginning of the specified vector into 16 base64 characters.
+ * The remaining 4 bytes of the vector are ignored.
+ */
+template <class Alphabet>
+static inline __m128i encodeVector(__m128i in)
+{
+	/**
+	 * Spread the 3-byte groups over 32-bit lanes, so that each lane holds the
+	 * bytes b1, b0, b2, b1 of its group (in little-endian order).
+	 */
+	in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+	
+	/**
+	 * Move each of the 4 6-bit numbers in a lane to the bottom of its own byte.
+	 * The 1st and 3rd numbers are shifted right with a high multiply and the 2nd
+	 * and 4th numbers are shifted left with a low multiply.
+	 */
+	__m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00));
+	__m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+	__m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003F03F0));
+	__m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+	__m128i indices = _mm_or_si128(t1, t3);
+	
+	/**
+	 * Translate the 6-bit numbers to characters by adding an offset that depends on
+	 * the alphabet range the number falls in. The range is reduced to a 4-bit index:
+	 * 13 for the uppercase letters, 0 for the lowercase ones, 1 to 10 for the digits,
+	 * 11 for 62 and 12 for 63.
+	 */
+	__m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+	__m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+	range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+	
+	const __m128i offsets = _mm_setr_epi8(
+		'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+		'0' - 52, '0' - 52, '0' - 52, Alphabet::char62 - 62, Alphabet::char63 - 63, 'A', 0, 0);
+	
+	return _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeSsse3(const byte * in, char * out, ulong inSize)
+{
+	/**
+	 * Each iteration encodes 24 bytes into 32 characters. The second 16-byte
+	 * load reads 4 bytes past the block, so stop while there are at least
+	 * 28 bytes left.
+	 */
+	ulong done = 0;
+	
+	while(done + 28 <= inSize)
+	{
+		__m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + done));
+		__m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + done + 12));
+		
+		char * outPtr = out + done / 3 * 4;
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(outPtr), encodeVector<Alphabet>(lo));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(outPtr + 16), encodeVector<Alphabet>(hi));
+		
+		done += 24;
+	}
+	
+	return done;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::validateSsse3(const char * in, ulong inSize)
+{
+	/**
+	 * The characters are classified by their nibbles, just like the AVX2 decoding kernel
+	 * does it. SSSE3 has no ptest, so the flags are compared to zero instead.
+	 */
+	const __m128i loNibbleFlags = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_tables.loNibbleFlags));
+	const __m128i hiNibbleFlags = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_tables.hiNibbleFlags));
+	const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+	
+	ulong done = 0;
+	
+	while(done + 16 <= inSize)
+	{
+		__m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + done));
+		__m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(chars, 4), nibbleMask);
+		__m128i loNibbles = _mm_and_si128(chars, nibbleMask);
+		__m128i invalid = _mm_and_si128(_mm_shuffle_epi8(loNibbleFlags, loNibbles), _mm_shuffle_epi8(hiNibbleFlags, hiNibbles));
+		
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(invalid, _mm_setzero_si128())) != 0xFFFF)
+			break;
+		
+		done += 16;
+	}
+	
+	return done;
+}
+
+/**
+ * For each of the 256 masks of the characters to keep out of 8, the pshufb pattern
+ * that moves those characters to the front of an 8-byte half, and how many there are.
+ */
+struct Base64Common::LeftPackTable
+{
+	uint64_t shuffle[256];
+	byte count[256];
+	
+	LeftPackTable()
+	{
+		for(uint mask = 0; mask < 256; mask++)
+		{
+			uint64_t pattern = 0;
+			uint n = 0;
+			
+			for(uint i = 0; i < 8; i++)
+			{
+				if(mask & (1 << i))
+					pattern |= static_cast<uint64_t>(i) << (8 * n++);
+			}
+			
+			shuffle[mask] = pattern;
+			count[mask] = n;
+		}
+	}
+};
+
+const Base64Common::LeftPackTable & Base64Common::leftPackTable()
+{
+	static const LeftPackTable table;
+	return table;
+}
+
+ulong Base64Common::compactSsse3(const char * in, char * out, ulong inSize, ulong & outLength)
+{
+	const LeftPackTable & table = leftPackTable();
+	const __m128i nine = _mm_set1_epi8(9);
+	const __m128i four = _mm_set1_epi8(4);
+	const __m128i space = _mm_set1_epi8(' ');
+	
+	ulong done = 0;
+	outLength = 0;
+	
+	while(done + 16 <= inSize)
+	{
+		__m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + done));
+		
+		/**
+		 * A character is whitespace if it is a space or if it falls in the '\t' to '\r'
+		 * range, which is tested with an unsigned min after moving the range down to 0.
+		 */
+		__m128i shifted = _mm_sub_epi8(chars, nine);
+		__m128i whitespace = _mm_or_si128(
+			_mm_cmpeq_epi8(_mm_min_epu8(shifted, four), shifted),
+			_mm_cmpeq_epi8(chars, space));
+		uint mask = _mm_movemask_epi8(whitespace);
+		
+		if(mask == 0)
+		{
+			/**
+			 * Most blocks have no whitespace at all and are copied as they are.
+			 */
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(out + outLength), chars);
+			outLength += 16;
+		}
+		else
+		{
+			/**
+			 * Left-pack each half separately, since pshufb patterns for all 16-bit
+			 * masks would make for a 1 MB table.
+			 */
+			uint keep = ~mask & 0xFFFF;
+			uint lo = keep & 0xFF;
+			uint hi = keep >> 8;
+			
+			__m128i packed = _mm_shuffle_epi8(chars, _mm_cvtsi64_si128(table.shuffle[lo]));
+			_mm_storel_epi64(reinterpret_cast<__m128i *>(out + outLength), packed);
+			outLength += table.count[lo];
+			
+			packed = _mm_shuffle_epi8(_mm_srli_si128(chars, 8), _mm_cvtsi64_si128(table.shuffle[hi]));
+			_mm_storel_epi64(reinterpret_cast<__m128i *>(out + outLength), packed);
+			outLength += table.count[hi];
+		}
+		
+		done += 16;
+	}
+	
+	return done;
+}
+
+#else
+
+/**
+ * The compiler cannot target this instruction set, so the kernels never process
+ * anything and the dispatcher never selects them anyway.
+ */
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeSsse3(const byte *, char *, ulong)
+{
+	return 0;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::validateSsse3(const char *, ulong)
+{
+	return 0;
+}
+
+ulong Base64Common::compactSsse3(const char *, char *, ulong, ulong & outLength)
+{
+	outLength = 0;
+	return 0;
+}
+
+#endif
+
+/**
+ * Compile the SSSE3 encoding and validation kernels for every alphabet.
+ */
+template ulong BasicBase64<StandardAlphabet>::encodeSsse3(const byte *, char *, ulong);
+template ulong BasicBase64<StandardAlphabet>::validateSsse3(const char *, ulong);
+template ulong BasicBase64<UrlAlphabet>::encodeSsse3(const byte *, char *, ulong);
+template ulong BasicBase64<UrlAlphabet>::validateSsse3(const char *, ulong);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::encodeSsse3(const byte *, char *, ulong);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::validateSsse3(const char *, ulong);
@@ -0,0 +1,231 @@
+/**
+ *	File:		Base64Stats.cpp
+ *	Author:		Alin Tomescu, tomescu.alin@gmail.com
+ *	Website:	http://alinush.org
+ *	Date: 		October 16th, 2026
+ *	License:	Free to use and distribute as long as this notice is kept.
+ */
+#include "Base64.h"
+
+#include <bit>
+#include <chrono>
+#include <exception>
+#include <mutex>
+
+const char * const Base64Common::_operationNames[NUM_OPERATIONS] =
+	{ "encodeBuffer", "decodeBuffer", "isValidEncoding", "encodeFile", "decodeFile" };
+
+std::atomic<bool> Base64Common::_statsEnabled(false);
+
+/**
+ * The counters of one operation on one thread. Only their thread writes to them, with plain
+ * loads and stores rather than atomic read-modify-writes, so they cost as much as non-atomic
+ * counters; they're only atomic so that getStats can read them from another thread.
+ */
+struct AtomicOperationStats
+{
+	std::atomic<ulong> calls;
+	std::atomic<ulong> failures;
+	std::atomic<ulong> errors[Base64Common::NUM_DECODE_ERRORS];
+	std::atomic<ulong> bytesIn;
+	std::atomic<ulong> bytesOut;
+	std::atomic<ulong> latency[Base64Common::NUM_LATENCY_BUCKETS];
+};
+
+static inline ulong counterValue(ulong counter)
+{
+	return counter;
+}
+
+static inline ulong counterValue(const std::atomic<ulong> & counter)
+{
+	return counter.load(std::memory_order_relaxed);
+}
+
+static inline void increase(std::atomic<ulong> & counter, ulong n)
+{
+	counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+/**
+ * Calls update(from, to) for every pair of matching counters of the two operations.
+ */
+template <class From, class To, class Update>
+static void forEachCounter(From & from, To & to, Update update)
+{
+	update(from.calls, to.calls);
+	update(from.failures, to.failures);
+	update(from.bytesIn, to.bytesIn);
+	update(from.bytesOut, to.bytesOut);
+
+	for(uint i = 0; i < Base64Common::NUM_DECODE_ERRORS; i++)
+		update(from.errors[i], to.errors[i]);
+
+	for(uint i = 0; i < Base64Common::NUM_LATENCY_BUCKETS; i++)
+		update(from.latency[i], to.latency[i]);
+}
+
+template <class From>
+static void addStats(const From (& from)[Base64Common::NUM_OPERATIONS], Base64Common::OperationStats (& to)[Base64Common::NUM_OPERATIONS])
+{
+	for(uint op = 0; op < Base64Common::NUM_OPERATIONS; op++)
+		forEachCounter(from[op], to[op], [](const auto & f, ulong & t) { t += counterValue(f); });
+}
+
+struct ThreadStats;
+
+/**
+ * Every thread that recorded a call, in an intrusive list so that registering a thread can't
+ * fail, and the sums of the threads that exited. The registry is never destroyed, since threads
+ * can still exit after the static objects are gone.
+ */
+struct StatsRegistry
+{
+	std::mutex mutex;
+	ThreadStats * threads = NULL;
+	Base64Common::OperationStats retired[Base64Common::NUM_OPERATIONS] = {};
+
+	/**
+	 * The sums at the last call to resetStats, which getStats subtracts. Only a thread
+	 * can write to its counters, so they're never reset themselves.
+	 */
+	Base64Common::OperationStats baseline[Base64Common::NUM_OPERATIONS] = {};
+};
+
+static StatsRegistry & statsRegistry()
+{
+	static StatsRegistry * registry = new StatsRegistry();
+	return *registry;
+}
+
+/**
+ * The counters of a thread, registered on its first recorded call and added to the retired
+ * sums when it exits.
+ */
+struct ThreadStats
+{
+	AtomicOperationStats operations[Base64Common::NUM_OPERATIONS] = {};
+	ThreadStats * prev = NULL;
+	ThreadStats * next = NULL;
+
+	ThreadStats()
+	{
+		StatsRegistry & registry = statsRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+
+		next = registry.threads;
+		if(next != NULL)
+			next->prev = this;
+		registry.threads = this;
+	}
+
+	~ThreadStats()
+	{
+		StatsRegistry & registry = statsRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+
+		addStats(operations, registry.retired);
+
+		if(prev != NULL)
+			prev->next = next;
+		else
+			registry.threads = next;
+		if(next != NULL)
+			next->prev = prev;
+	}
+};
+
+static thread_local ThreadStats t_stats;
+
+/**
+ * How many StatsScope objects are open on this thread.
+ */
+static thread_local uint t_statsDepth = 0;
+
+static inline ulong nowNanoseconds()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Base64Common::StatsScope::start() noexcept
+{
+	_counted = true;
+	_recording = t_statsDepth++ == 0 && _operation != NUM_OPERATIONS;
+
+	if(_recording)
+	{
+		_exceptions = std::uncaught_exceptions();
+		_start = nowNanoseconds();
+	}
+}
+
+void Base64Common::StatsScope::stop() noexcept
+{
+	t_statsDepth--;
+	if(!_recording)
+		return;
+
+	ulong elapsed = nowNanoseconds() - _start;
+	uint bucket = std::bit_width(elapsed);
+	AtomicOperationStats & stats = t_stats.operations[_operation];
+
+	increase(stats.calls, 1);
+	increase(stats.latency[bucket < NUM_LATENCY_BUCKETS ? bucket : NUM_LATENCY_BUCKETS - 1], 1);
+
+	if(_error != DECODE_OK)
+		increase(stats.errors[_error], 1);
+	else if(std::uncaught_exceptions() > _exceptions)
+		increase(stats.failures, 1);
+	else
+	{
+		increase(stats.bytesIn, _bytesIn);
+		increase(stats.bytesOut, _bytesOut);
+	}
+}
+
+void Base64Common::setStatsEnabled(bool enabled)
+{
+	_statsEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Base64Common::isStatsEnabled()
+{
+	return _statsEnabled.load(std::memory_order_relaxed);
+}
+
+Base64Common::Stats Base64Common::getStats()
+{
+	Stats stats = {};
+	stats.backend = getBackend();
+
+	StatsRegistry & registry = statsRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+
+	addStats(registry.retired, stats.operations);
+	for(ThreadStats * thread = registry.threads; thread != NULL; thread = thread->next)
+		addStats(thread->operations, stats.operations);
+
+	for(uint op = 0; op < NUM_OPERATIONS; op++)
+		forEachCounter(registry.baseline[op], stats.operations[op], [](ulong f, ulong & t) { t -= f; });
+
+	return stats;
+}
+
+void Base64Common::resetStats()
+{
+	StatsRegistry & registry = statsRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+
+	OperationStats sums[NUM_OPERATIONS] = {};
+	addStats(registry.retired, sums);
+	for(ThreadStats * thread = registry.threads; thread != NULL; thread = thread->next)
+		addStats(thread->operations, sums);
+
+	for(uint op = 0; op < NUM_OPERATIONS; op++)
+		registry.baseline[op] = sums[op];
+}
+
+const char * Base64Common::getOperationName(Operation operation)
+{
+	return _operationNames[operation];
+}
@@ -0,0 +1,321 @@
+/**
+ *	File:		Base64Stream.cpp
+ *	Author:		Alin Tomescu, tomescu.alin@gmail.com
+ *	Website:	http://alinush.org
+ *	Date: 		October 16th, 2026
+ *	License:	Free to use and distribute as long as this notice is kept.
+ */
+#include "Base64.h"
+
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::Encoder::update(const byte * in, char * out, ulong inSize)
+{
+	ulong outLength = 0;
+	
+	/**
+	 * Complete the block left over from the previous call, if any.
+	 */
+	if(_pendingSize > 0)
+	{
+		while(_pendingSize < 3 && inSize > 0)
+		{
+			_pending[_pendingSize++] = *in++;
+			inSize--;
+		}
+		
+		if(_pendingSize < 3)
+			return 0;
+		
+		encodeBlock(_pending, out, 3);
+		outLength += 4;
+		_pendingSize = 0;
+	}
+	
+	/**
+	 * Encode all the complete blocks in the chunk and keep the rest for later.
+	 */
+	ulong bulkSize = inSize - inSize % 3;
+	outLength += encodeBuffer(in, out + outLength, bulkSize);
+	
+	_pendingSize = inSize - bulkSize;
+	memcpy(_pending, in + bulkSize, _pendingSize);
+	
+	return outLength;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::Encoder::finish(char * out)
+{
+	if(_pendingSize == 0)
+		return 0;
+	
+	encodeBlock(_pending, out, _pendingSize);
+	ulong length = getEncodedSize(_pendingSize);
+	_pendingSize = 0;
+	
+	return length;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::Decoder::update(const char * in, byte * out, ulong inSize)
+{
+	ulong outLength = 0;
+	
+	/**
+	 * Complete the block left over from the previous call, if any.
+	 */
+	if(_pendingSize > 0)
+	{
+		while(_pendingSize < 4 && inSize > 0)
+		{
+			_pending[_pendingSize++] = *in++;
+			inSize--;
+		}
+		
+		if(_pendingSize < 4)
+			return 0;
+		
+		outLength += decodeBlocks(_pending, out, 4);
+		_pendingSize = 0;
+	}
+	
+	/**
+	 * Decode all the complete blocks in the chunk and keep the rest for later.
+	 */
+	ulong bulkSize = inSize - inSize % 4;
+	outLength += decodeBlocks(in, out + outLength, bulkSize);
+	
+	_pendingSize = inSize - bulkSize;
+	memcpy(_pending, in + bulkSize, _pendingSize);
+	
+	return outLength;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::Decoder::finish(byte * out)
+{
+	uint pendingSize = _pendingSize;
+	ulong offset = _offset;
+	
+	_pendingSize = 0;
+	_offset = 0;
+	_padded = false;
+	
+	if(pendingSize == 0)
+		return 0;
+	
+	if(!isValidLength(pendingSize))
+		throw invalidLengthError("base64-encoded data", offset + pendingSize);
+	
+	/**
+	 * Without padding, the encoding can end in a partial block, which is only decoded now.
+	 */
+	ulong decodedLength;
+	ulong errorOffset = decodeFused(_pending, out, pendingSize, decodedLength);
+	
+	if(errorOffset != pendingSize)
+		throw invalidCharError(_pending[errorOffset], offset + errorOffset);
+	
+	return decodedLength;
+}
+
+template <class Alphabet>
+void BasicBase64<Alphabet>::Decoder::resume(ulong offset, bool padded, const char * pending)
+{
+	_pendingSize = offset % 4;
+	_offset = offset - _pendingSize;
+	_padded = padded;
+	memcpy(_pending, pending, _pendingSize);
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::Decoder::decodeBlocks(const char * in, byte * out, ulong inSize)
+{
+	if(inSize == 0)
+		return 0;
+	
+	/**
+	 * Padding can only end the encoding, so there can't be anything after it.
+	 */
+	if(_padded)
+	{
+		std::ostringstream error;
+		error << "The input string is not a valid base64 encoding: data found after padding at offset "
+			<< _offset << ".";
+		throw std::runtime_error(error.str());
+	}
+	
+	ulong decodedLength;
+	ulong errorOffset = decodeFused(in, out, inSize, decodedLength);
+	
+	if(errorOffset != inSize)
+		throw invalidCharError(in[errorOffset], _offset + errorOffset);
+	
+	_offset += inSize;
+	_padded = in[inSize - 1] == _paddingChar;
+	
+	return decodedLength;
+}
+
+/**
+ * The start and the size of a fragment of encodeFragments or decodeFragments.
+ */
+static inline const void * fragmentData(const iovec & fragment) { return fragment.iov_base; }
+static inline ulong fragmentSize(const iovec & fragment) { return fragment.iov_len; }
+static inline const void * fragmentData(const std::span<const std::byte> & fragment) { return fragment.data(); }
+static inline ulong fragmentSize(const std::span<const std::byte> & fragment) { return fragment.size(); }
+static inline const void * fragmentData(const std::string_view & fragment) { return fragment.data(); }
+static inline ulong fragmentSize(const std::string_view & fragment) { return fragment.size(); }
+
+template <class Alphabet>
+template <class Fragment>
+ulong BasicBase64<Alphabet>::encodeFragmentsOf(std::span<const Fragment> fragments, std::span<char> out)
+{
+	ulong inSize = 0;
+	for(ulong i = 0; i < fragments.size(); i++)
+		inSize += fragmentSize(fragments[i]);
+	
+	StatsScope stats(ENCODE_BUFFER, inSize);
+	
+	if(out.size() < getEncodedSize(inSize))
+	{
+		std::ostringstream error;
+		error << "The output buffer (" << out.size() << " characters) is too small for the base64 encoding ("
+			<< getEncodedSize(inSize) << " characters).";
+		throw std::runtime_error(error.str());
+	}
+	
+	/**
+	 * The encoder only writes whole blocks, so it never writes past the encoded size.
+	 */
+	Encoder encoder;
+	ulong outLength = 0;
+	
+	for(ulong i = 0; i < fragments.size(); i++)
+	{
+		const byte * in = static_cast<const byte *>(fragmentData(fragments[i]));
+		outLength += encoder.update(in, out.data() + outLength, fragmentSize(fragments[i]));
+	}
+	
+	outLength += encoder.finish(out.data() + outLength);
+	return stats.finish(outLength);
+}
+
+template <class Alphabet>
+template <class Fragment>
+ulong BasicBase64<Alphabet>::decodeFragmentsOf(std::span<const Fragment> fragments, std::span<std::byte> out)
+{
+	/**
+	 * The exact decoded size depends on the padding, whose 2 characters can be in
+	 * different fragments, so they're gathered from the last fragments first.
+	 */
+	ulong inSize = 0;
+	for(ulong i = 0; i < fragments.size(); i++)
+		inSize += fragmentSize(fragments[i]);
+	
+	char last[2] = { 0, 0 };
+	uint nLast = 0;
+	for(ulong i = fragments.size(); i > 0 && nLast < 2; i--)
+	{
+		const char * fragment = static_cast<const char *>(fragmentData(fragments[i - 1]));
+		for(ulong j = fragmentSize(fragments[i - 1]); j > 0 && nLast < 2; j--)
+			last[1 - nLast++] = fragment[j - 1];
+	}
+	
+	StatsScope stats(DECODE_BUFFER, inSize);
+	
+	if(!isValidLength(inSize))
+		throw decodeError(stats.finish(DecodeResult { INVALID_LENGTH, inSize, 0 }), NULL);
+	
+	ulong nPadding = 0;
+	if(Alphabet::padding && inSize >= 4 && last[1] == _paddingChar)
+		nPadding = last[0] == _paddingChar ? 2 : 1;
+	
+	ulong decodedSize = getDecodedSize(inSize) - nPadding;
+	if(out.size() < decodedSize)
+		throw decodeError(stats.finish(DecodeResult { OUTPUT_TOO_SMALL, 0, decodedSize }), NULL);
+	
+	/**
+	 * Once the length is known to be valid, the decoder can only run into invalid characters.
+	 */
+	Decoder decoder;
+	byte * outPtr = reinterpret_cast<byte *>(out.data());
+	ulong outLength = 0;
+	
+	try
+	{
+		for(ulong i = 0; i < fragments.size(); i++)
+		{
+			const char * in = static_cast<const char *>(fragmentData(fragments[i]));
+			outLength += decoder.update(in, outPtr + outLength, fragmentSize(fragments[i]));
+		}
+		
+		outLength += decoder.finish(outPtr + outLength);
+	}
+	catch(std::runtime_error &)
+	{
+		stats.finish(DecodeResult { INVALID_CHARACTER, 0, 0 });
+		throw;
+	}
+	
+	return stats.finish(outLength);
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeFragments(std::span<const iovec> fragments, std::span<char> out)
+{
+	return encodeFragmentsOf(fragments, out);
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeFragments(std::span<const std::span<const std::byte>> fragments, std::span<char> out)
+{
+	return encodeFragmentsOf(fragments, out);
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeFragments(std::span<const iovec> fragments, std::span<std::byte> out)
+{
+	return decodeFragmentsOf(fragments, out);
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeFragments(std::span<const std::string_view> fragments, std::span<std::byte> out)
+{
+	return decodeFragmentsOf(fragments, out);
+}
+
+/**
+ * Compile the streaming and scatter-gather codecs for every alphabet.
+ */
+template ulong BasicBase64<StandardAlphabet>::Encoder::update(const byte *, char *, ulong);
+template ulong BasicBase64<StandardAlphabet>::Encoder::finish(char *);
+template ulong BasicBase64<StandardAlphabet>::Decoder::update(const char *, byte *, ulong);
+template ulong BasicBase64<StandardAlphabet>::Decoder::finish(byte *);
+template void BasicBase64<StandardAlphabet>::Decoder::resume(ulong, bool, const char *);
+template ulong BasicBase64<StandardAlphabet>::encodeFragments(std::span<const iovec>, std::span<char>);
+template ulong BasicBase64<StandardAlphabet>::encodeFragments(std::span<const std::span<const std::byte>>, std::span<char>);
+template ulong BasicBase64<StandardAlphabet>::decodeFragments(std::span<const iovec>, std::span<std::byte>);
+template ulong BasicBase64<StandardAlphabet>::decodeFragments(std::span<const std::string_view>, std::span<std::byte>);
+template ulong BasicBase64<UrlAlphabet>::Encoder::update(const byte *, char *, ulong);
+template ulong BasicBase64<UrlAlphabet>::Encoder::finish(char *);
+template ulong BasicBase64<UrlAlphabet>::Decoder::update(const char *, byte *, ulong);
+template ulong BasicBase64<UrlAlphabet>::Decoder::finish(byte *);
+template void BasicBase64<UrlAlphabet>::Decoder::resume(ulong, bool, const char *);
+template ulong BasicBase64<UrlAlphabet>::encodeFragments(std::span<const iovec>, std::span<char>);
+template ulong BasicBase64<UrlAlphabet>::encodeFragments(std::span<const std::span<const std::byte>>, std::span<char>);
+template ulong BasicBase64<UrlAlphabet>::decodeFragments(std::span<const iovec>, std::span<std::byte>);
+template ulong BasicBase64<UrlAlphabet>::decodeFragments(std::span<const std::string_view>, std::span<std::byte>);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::Encoder::update(const byte *, char *, ulong);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::Encoder::finish(char *);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::Decoder::update(const char *, byte *, ulong);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::Decoder::finish(byte *);
+template void BasicBase64<UrlUnpaddedAlphabet>::Decoder::resume(ulong, bool, const char *);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::encodeFragments(std::span<const iovec>, std::span<char>);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::encodeFragments(std::span<const std::span<const std::byte>>, std::span<char>);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::decodeFragments(std::span<const iovec>, std::span<std::byte>);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::decodeFragments(std::span<const std::string_view>, std::span<std::byte>);
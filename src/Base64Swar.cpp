@@ -0,0 +1,172 @@
+/**
+ *	File:		Base64Swar.cpp
+ *	Author:		Alin Tomescu, tomescu.alin@gmail.com
+ *	Website:	http://alinush.org
+ *	Date: 		October 16th, 2026
+ *	License:	Free to use and distribute as long as this notice is kept.
+ */
+#include "Base64.h"
+
+#include <cstring>
+#include <stdint.h>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+
+/**
+ * The value OR'ed into the decoded word by the decoding tables for characters
+ * outside the alphabet. Valid characters never touch the high byte of the word.
+ */
+static const uint32_t invalidBit = 0x80000000;
+
+/**
+ * The lookup tables used by the SWAR kernels, computed from the base64 alphabet
+ * the first time they're needed.
+ */
+template <class Alphabet>
+struct BasicBase64<Alphabet>::SwarTables
+{
+	/**
+	 * Maps every 12-bit number to the two characters encoding it,
+	 * the first one in the low byte.
+	 */
+	uint16_t pairs[4096];
+	
+	/**
+	 * Map every character, depending on its position in a 4-character block, to its
+	 * 6-bit number shifted to where it goes in the 3 decoded bytes, as they're laid out
+	 * in a little-endian 32-bit word. Characters outside the alphabet map to invalidBit.
+	 */
+	uint32_t decode[4][256];
+	
+	SwarTables()
+	{
+		for(uint i = 0; i < 4096; i++)
+			pairs[i] = static_cast<byte>(_tables.byteToChar[i >> 6]) | (static_cast<byte>(_tables.byteToChar[i & 0x3F]) << 8);
+		
+		for(uint ch = 0; ch < 256; ch++)
+		{
+			uint32_t n = _tables.charToByte[ch];
+			
+			if(n & 0x80)
+			{
+				decode[0][ch] = decode[1][ch] = decode[2][ch] = decode[3][ch] = invalidBit;
+				continue;
+			}
+			
+			decode[0][ch] = n << 2;
+			decode[1][ch] = (n >> 4) | ((n & 0x0F) << 12);
+			decode[2][ch] = ((n >> 2) << 8) | ((n & 0x03) << 22);
+			decode[3][ch] = n << 16;
+		}
+	}
+};
+
+template <class Alphabet>
+const typename BasicBase64<Alphabet>::SwarTables & BasicBase64<Alphabet>::swarTables()
+{
+	static const SwarTables tables;
+	return tables;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeSwar(const byte * in, char * out, ulong inSize)
+{
+	const uint16_t * pairs = swarTables().pairs;
+	
+	/**
+	 * Each iteration encodes 6 bytes into 8 characters. The bytes are read with
+	 * an 8-byte load, so stop while there are at least 8 bytes left.
+	 */
+	ulong done = 0;
+	
+	while(done + 8 <= inSize)
+	{
+		uint64_t word;
+		memcpy(&word, in + done, sizeof(word));
+		
+		/**
+		 * Put the 6 bytes in big-endian order in the low 48 bits of the word,
+		 * and look up each of its four 12-bit numbers.
+		 */
+		word = __builtin_bswap64(word) >> 16;
+		
+		uint64_t chars = 
+			static_cast<uint64_t>(pairs[(word >> 36) & 0xFFF]) |
+			(static_cast<uint64_t>(pairs[(word >> 24) & 0xFFF]) << 16) |
+			(static_cast<uint64_t>(pairs[(word >> 12) & 0xFFF]) << 32) |
+			(static_cast<uint64_t>(pairs[word & 0xFFF]) << 48);
+		
+		memcpy(out + done / 3 * 4, &chars, sizeof(chars));
+		
+		done += 6;
+	}
+	
+	return done;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeSwar(const char * in, byte * out, ulong inSize)
+{
+	const uint32_t (* decode)[256] = swarTables().decode;
+	const byte * inPtr = reinterpret_cast<const byte *>(in);
+	
+	/**
+	 * The input is decoded in runs of 16 blocks and the decoded words are OR'ed together,
+	 * so an invalid character is detected with a single check per run. Each block is
+	 * stored with a 4-byte write, which spills into the next block's output, so the
+	 * last block of the input is never touched, just like in the vectorized kernels.
+	 */
+	const ulong runSize = 64;
+	ulong done = 0;
+	
+	while(done + runSize + 4 <= inSize)
+	{
+		uint32_t sentinel = 0;
+		
+		for(ulong i = done; i < done + runSize; i += 4)
+		{
+			uint32_t word = decode[0][inPtr[i]] | decode[1][inPtr[i + 1]] |
+				decode[2][inPtr[i + 2]] | decode[3][inPtr[i + 3]];
+			sentinel |= word;
+			
+			memcpy(out + i / 4 * 3, &word, sizeof(word));
+		}
+		
+		if(sentinel & invalidBit)
+			break;
+		
+		done += runSize;
+	}
+	
+	return done;
+}
+
+#else
+
+/**
+ * The kernels rely on the little-endian layout of the words they load and store,
+ * so on other platforms they never encode (or decode) anything.
+ */
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::encodeSwar(const byte *, char *, ulong)
+{
+	return 0;
+}
+
+template <class Alphabet>
+ulong BasicBase64<Alphabet>::decodeSwar(const char *, byte *, ulong)
+{
+	return 0;
+}
+
+#endif
+
+/**
+ * Compile the SWAR kernels for every alphabet.
+ */
+template ulong BasicBase64<StandardAlphabet>::encodeSwar(const byte *, char *, ulong);
+template ulong BasicBase64<StandardAlphabet>::decodeSwar(const char *, byte *, ulong);
+template ulong BasicBase64<UrlAlphabet>::encodeSwar(const byte *, char *, ulong);
+template ulong BasicBase64<UrlAlphabet>::decodeSwar(const char *, byte *, ulong);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::encodeSwar(const byte *, char *, ulong);
+template ulong BasicBase64<UrlUnpaddedAlphabet>::decodeSwar(const char *, byte *, ulong);
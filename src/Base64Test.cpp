@@ -15,12 +15,20 @@
 #include <vector>
 #include <sstream>
 #include <string>
-using namespace std;
+#include <algorithm>
+#include <thread>
+using std::cout;
+using std::endl;
+using std::string;
 
 #include "Base64.h"
 
 std::string base64_file_encode(const std::string& filePath);
 
+void testFiles();
+void testFileErrors();
+void testFileLayouts();
+
 std::string base64_encode(const std::string& input)
 {
 	ulong size = Base64::getEncodedSize(input.length()) + 1;
@@ -196,6 +204,491 @@ void fuzzyTest()
 	
 }
 
+void testInvalidDecodings()
+{
+	const char * invalid[] = {
+		"a", "abc", "a===", "ab=c", "=abc",
+		"abcde", "====", "+--4", "4++)",
+		"a=bc", "abcd=bcd", "abcdabc\xff", "ab\ncd==",
+	};
+	
+	byte buffer[16];
+	for(uint i = 0; i < sizeof(invalid)/sizeof(invalid[0]); i++)
+	{
+		bool thrown = false;
+		try
+		{
+			Base64::decodeBuffer(invalid[i], buffer, strlen(invalid[i]));
+		}
+		catch(std::runtime_error&)
+		{
+			thrown = true;
+		}
+		
+		if(!thrown)
+			throw std::runtime_error("Base64 invalid decodings test failed: Decoding \"" + std::string(invalid[i]) + "\" did not fail.");
+	}
+	
+	//	Corrupt a random character in random valid encodings
+	const uint maxBufferLength = 512;
+	byte input[maxBufferLength];
+	char encoded[Base64::getEncodedSize(maxBufferLength)];
+	byte decoded[maxBufferLength];
+	
+	for(uint i = 0; i < 10000; i++)
+	{
+		uint length = getRandomBuffer(input, maxBufferLength);
+		ulong encodedLength = Base64::encodeBuffer(input, encoded, length);
+		if(encodedLength == 0)
+			continue;
+		
+		char badChar;
+		do {
+			badChar = static_cast<char>(getRandomNumber(0, 256));
+		} while(isalnum(static_cast<byte>(badChar)) || badChar == '+' || badChar == '/');
+		
+		ulong position = getRandomNumber(0, encodedLength);
+		encoded[position] = badChar;
+		
+		bool thrown = false;
+		try
+		{
+			Base64::decodeBuffer(encoded, decoded, encodedLength);
+		}
+		catch(std::runtime_error&)
+		{
+			thrown = true;
+		}
+		
+		if(!thrown && !(badChar == '=' && position >= encodedLength - 2))
+		{
+			std::ostringstream error;
+			error << "Base64 invalid decodings test failed: Decoding an encoding with ASCII code "
+				<< static_cast<unsigned short>(static_cast<byte>(badChar)) << " at offset " << position << " did not fail.";
+			throw std::runtime_error(error.str());
+		}
+	}
+}
+
+/**
+ * Restores the backend that was in use when it was created, even if a test throws.
+ */
+class BackendGuard
+{
+	public:
+		BackendGuard() : _original(Base64::getBackend()) {}
+		~BackendGuard() { Base64::setBackend(_original); }
+		
+	private:
+		Base64::Backend _original;
+};
+
+/**
+ * Calls test with every backend the CPU supports, after switching to it.
+ */
+template <class Test>
+void forEachBackend(Test test)
+{
+	BackendGuard guard;
+	
+	for(int b = Base64::SCALAR; b < Base64::NUM_BACKENDS; b++)
+	{
+		Base64::Backend backend = static_cast<Base64::Backend>(b);
+		if(!Base64::isBackendSupported(backend))
+			continue;
+		
+		Base64::setBackend(backend);
+		test(backend);
+	}
+}
+
+void testBackends()
+{
+	//	Every supported backend must produce exactly what the scalar backend produces
+	const uint maxBufferLength = 4096;
+	byte buffer[maxBufferLength];
+	char expected[Base64::getEncodedSize(maxBufferLength)];
+	char encoded[Base64::getEncodedSize(maxBufferLength)];
+	byte decoded[maxBufferLength];
+	
+	BackendGuard guard;
+	
+	for(uint i = 0; i < 2000; i++)
+	{
+		uint length = getRandomBuffer(buffer, maxBufferLength);
+		
+		Base64::setBackend(Base64::SCALAR);
+		ulong expectedLength = Base64::encodeBuffer(buffer, expected, length);
+		
+		forEachBackend([&](Base64::Backend backend)
+		{
+			ulong encodedLength = Base64::encodeBuffer(buffer, encoded, length);
+			if(encodedLength != expectedLength || memcmp(encoded, expected, encodedLength) != 0)
+				throw std::runtime_error(std::string("Base64 backends test failed: The ") + 
+					Base64::getBackendName(backend) + " backend encoded a random buffer differently.");
+			
+			ulong decodedLength = Base64::decodeBuffer(encoded, decoded, encodedLength);
+			if(decodedLength != length || memcmp(decoded, buffer, length) != 0)
+				throw std::runtime_error(std::string("Base64 backends test failed: The ") + 
+					Base64::getBackendName(backend) + " backend decoded a random buffer differently.");
+		});
+	}
+}
+
+void testStreaming()
+{
+	//	Encoding and decoding in random chunks must give the same result as doing it all at once
+	const uint maxBufferLength = 4096;
+	byte buffer[maxBufferLength];
+	char expected[Base64::getEncodedSize(maxBufferLength)];
+	char encoded[Base64::getEncodedSize(maxBufferLength)];
+	byte decoded[maxBufferLength];
+	
+	for(uint i = 0; i < 2000; i++)
+	{
+		uint length = getRandomBuffer(buffer, maxBufferLength);
+		ulong expectedLength = Base64::encodeBuffer(buffer, expected, length);
+		
+		Base64::Encoder encoder;
+		ulong encodedLength = 0;
+		for(uint done = 0; done < length; )
+		{
+			uint chunkSize = getRandomNumber(0, std::min(length - done, 100u) + 1);
+			encodedLength += encoder.update(buffer + done, encoded + encodedLength, chunkSize);
+			done += chunkSize;
+		}
+		encodedLength += encoder.finish(encoded + encodedLength);
+		
+		if(encodedLength != expectedLength || memcmp(encoded, expected, encodedLength) != 0)
+			throw std::runtime_error("Base64 streaming test failed: Encoding a random buffer in chunks gave a different result.");
+		
+		Base64::Decoder decoder;
+		ulong decodedLength = 0;
+		for(ulong done = 0; done < encodedLength; )
+		{
+			ulong chunkSize = getRandomNumber(0, std::min(encodedLength - done, 100ul) + 1);
+			decodedLength += decoder.update(encoded + done, decoded + decodedLength, chunkSize);
+			done += chunkSize;
+		}
+		decodedLength += decoder.finish(decoded + decodedLength);
+		
+		if(decodedLength != length || memcmp(decoded, buffer, length) != 0)
+			throw std::runtime_error("Base64 streaming test failed: Decoding a random buffer in chunks gave a different result.");
+	}
+	
+	//	Data after padding and truncated data must be rejected
+	const char * invalid[] = { "YQ==YQ==", "YWI=Y", "YWJjYW" };
+	
+	for(uint i = 0; i < sizeof(invalid)/sizeof(invalid[0]); i++)
+	{
+		Base64::Decoder decoder;
+		bool thrown = false;
+		try
+		{
+			for(const char * p = invalid[i]; *p; p++)
+				decoder.update(p, decoded, 1);
+			decoder.finish(decoded);
+		}
+		catch(std::runtime_error&)
+		{
+			thrown = true;
+		}
+		
+		if(!thrown)
+			throw std::runtime_error("Base64 streaming test failed: Decoding \"" + std::string(invalid[i]) + "\" in chunks did not fail.");
+	}
+}
+
+void testLenient()
+{
+	//	Whitespace anywhere in an encoding must be skipped, on every supported backend
+	const uint maxBufferLength = 8192;
+	const char whitespace[] = " \t\n\v\f\r";
+	byte buffer[maxBufferLength];
+	char encoded[Base64::getEncodedSize(maxBufferLength)];
+	byte decoded[maxBufferLength];
+	
+	for(uint i = 0; i < 500; i++)
+	{
+		uint length = getRandomBuffer(buffer, maxBufferLength);
+		ulong encodedLength = Base64::encodeBuffer(buffer, encoded, length);
+		
+		//	Some encodings have long runs without whitespace, others have whitespace everywhere
+		uint spacing = getRandomNumber(2, 200);
+		std::string spaced;
+		for(ulong j = 0; j < encodedLength; j++)
+		{
+			while(getRandomNumber(0, spacing) == 0)
+				spaced += whitespace[getRandomNumber(0, 6)];
+			spaced += encoded[j];
+		}
+		
+		forEachBackend([&](Base64::Backend backend)
+		{
+			ulong decodedLength = Base64::decodeBufferLenient(spaced.c_str(), decoded, spaced.length());
+			if(decodedLength != length || memcmp(decoded, buffer, length) != 0)
+				throw std::runtime_error(std::string("Base64 lenient test failed: The ") + 
+					Base64::getBackendName(backend) + " backend decoded an encoding with whitespace differently.");
+			
+			//	Any other invalid character must still be caught, at its offset in the input (padding
+			//	is left alone, since corrupting the last padding character gets the one before it reported)
+			if(encodedLength == 0)
+				return;
+			
+			std::string corrupted = spaced;
+			ulong position;
+			do {
+				position = getRandomNumber(0, corrupted.length());
+			} while(strchr(whitespace, corrupted[position]) != NULL || corrupted[position] == '=');
+			corrupted[position] = '*';
+			
+			std::ostringstream expected;
+			expected << "at offset " << position << ".";
+			
+			bool thrown = false;
+			try
+			{
+				Base64::decodeBufferLenient(corrupted.c_str(), decoded, corrupted.length());
+			}
+			catch(std::runtime_error& e)
+			{
+				thrown = std::string(e.what()).find(expected.str()) != std::string::npos;
+			}
+			
+			if(!thrown)
+				throw std::runtime_error(std::string("Base64 lenient test failed: The ") + 
+					Base64::getBackendName(backend) + " backend did not report an invalid character at its offset.");
+		});
+	}
+	
+	//	Once the whitespace is gone, what is left must still be a valid encoding
+	const char * invalid[] = { "YQ= =YQ==", "YW\nI", "Y Q =", "YW Jj\r\nYW", "Y*==" };
+	
+	for(uint i = 0; i < sizeof(invalid)/sizeof(invalid[0]); i++)
+	{
+		bool thrown = false;
+		try
+		{
+			Base64::decodeBufferLenient(invalid[i], decoded, strlen(invalid[i]));
+		}
+		catch(std::runtime_error&)
+		{
+			thrown = true;
+		}
+		
+		if(!thrown)
+			throw std::runtime_error("Base64 lenient test failed: Decoding \"" + std::string(invalid[i]) + "\" did not fail.");
+	}
+}
+
+void testAlphabets()
+{
+	//	The URL-safe encodings must be the standard one with '-' and '_' for '+' and '/', with and
+	//	without the padding, on every supported backend, and must decode back to the same data
+	const uint maxBufferLength = 4096;
+	byte buffer[maxBufferLength];
+	char expected[Base64::getEncodedSize(maxBufferLength)];
+	char encoded[Base64::getEncodedSize(maxBufferLength)];
+	byte decoded[maxBufferLength];
+	
+	BackendGuard guard;
+	
+	for(uint i = 0; i < 1000; i++)
+	{
+		uint length = getRandomBuffer(buffer, maxBufferLength);
+		
+		Base64::setBackend(Base64::SCALAR);
+		ulong expectedLength = Base64::encodeBuffer(buffer, expected, length);
+		std::replace(expected, expected + expectedLength, '+', '-');
+		std::replace(expected, expected + expectedLength, '/', '_');
+		ulong unpaddedLength = std::find(expected, expected + expectedLength, '=') - expected;
+		
+		if(Base64UrlUnpadded::getEncodedSize(length) != unpaddedLength)
+			throw std::runtime_error("Base64 alphabets test failed: The size of an unpadded encoding is wrong.");
+		
+		forEachBackend([&](Base64::Backend backend)
+		{
+			ulong encodedLength = Base64Url::encodeBuffer(buffer, encoded, length);
+			if(encodedLength != expectedLength || memcmp(encoded, expected, encodedLength) != 0)
+				throw std::runtime_error(std::string("Base64 alphabets test failed: The ") + 
+					Base64::getBackendName(backend) + " backend encoded a random buffer in base64url differently.");
+			
+			ulong decodedLength = Base64Url::decodeBuffer(encoded, decoded, encodedLength);
+			if(decodedLength != length || memcmp(decoded, buffer, length) != 0)
+				throw std::runtime_error(std::string("Base64 alphabets test failed: The ") + 
+					Base64::getBackendName(backend) + " backend decoded a random base64url buffer differently.");
+			
+			encodedLength = Base64UrlUnpadded::encodeBuffer(buffer, encoded, length);
+			if(encodedLength != unpaddedLength || memcmp(encoded, expected, encodedLength) != 0)
+				throw std::runtime_error(std::string("Base64 alphabets test failed: The ") + 
+					Base64::getBackendName(backend) + " backend encoded a random buffer in unpadded base64url differently.");
+			
+			decodedLength = Base64UrlUnpadded::decodeBuffer(encoded, decoded, encodedLength);
+			if(decodedLength != length || memcmp(decoded, buffer, length) != 0)
+				throw std::runtime_error(std::string("Base64 alphabets test failed: The ") + 
+					Base64::getBackendName(backend) + " backend decoded a random unpadded base64url buffer differently.");
+			
+			//	The standard characters for 62 and 63 are not in the alphabet
+			if(encodedLength == 0)
+				return;
+			
+			encoded[getRandomNumber(0, encodedLength)] = getRandomNumber(0, 2) ? '+' : '/';
+			
+			bool thrown = false;
+			try
+			{
+				Base64UrlUnpadded::decodeBuffer(encoded, decoded, encodedLength);
+			}
+			catch(std::runtime_error&)
+			{
+				thrown = true;
+			}
+			
+			if(!thrown)
+				throw std::runtime_error(std::string("Base64 alphabets test failed: The ") + 
+					Base64::getBackendName(backend) + " backend decoded a '+' or a '/' in unpadded base64url.");
+		});
+		
+		//	Unpadded encodings end in a partial block, which the streaming decoder only decodes when finished
+		Base64UrlUnpadded::Decoder decoder;
+		ulong decodedLength = 0;
+		for(ulong done = 0; done < unpaddedLength; )
+		{
+			ulong chunkSize = getRandomNumber(0, std::min(unpaddedLength - done, 100ul) + 1);
+			decodedLength += decoder.update(expected + done, decoded + decodedLength, chunkSize);
+			done += chunkSize;
+		}
+		decodedLength += decoder.finish(decoded + decodedLength);
+		
+		if(decodedLength != length || memcmp(decoded, buffer, length) != 0)
+			throw std::runtime_error("Base64 alphabets test failed: Decoding an unpadded encoding in chunks gave a different result.");
+	}
+	
+	//	Each alphabet must reject the characters of the others, and the unpadded one the padding
+	const char * invalidUrl[] = { "ab+c", "ab/c", "YQ=a", "Y===" };
+	const char * invalidUnpadded[] = { "YQ==", "YWI=", "Y", "YWJjZ", "ab/c" };
+	
+	for(uint i = 0; i < sizeof(invalidUrl)/sizeof(invalidUrl[0]); i++)
+	{
+		bool thrown = false;
+		try
+		{
+			Base64Url::decodeBuffer(invalidUrl[i], decoded, strlen(invalidUrl[i]));
+		}
+		catch(std::runtime_error&)
+		{
+			thrown = true;
+		}
+		
+		if(!thrown || Base64Url::isValidEncoding(invalidUrl[i], strlen(invalidUrl[i])))
+			throw std::runtime_error("Base64 alphabets test failed: Decoding \"" + std::string(invalidUrl[i]) + "\" in base64url did not fail.");
+	}
+	
+	for(uint i = 0; i < sizeof(invalidUnpadded)/sizeof(invalidUnpadded[0]); i++)
+	{
+		bool thrown = false;
+		try
+		{
+			Base64UrlUnpadded::decodeBuffer(invalidUnpadded[i], decoded, strlen(invalidUnpadded[i]));
+		}
+		catch(std::runtime_error&)
+		{
+			thrown = true;
+		}
+		
+		if(!thrown || Base64UrlUnpadded::isValidEncoding(invalidUnpadded[i], strlen(invalidUnpadded[i])))
+			throw std::runtime_error("Base64 alphabets test failed: Decoding \"" + std::string(invalidUnpadded[i]) + 
+				"\" in unpadded base64url did not fail.");
+	}
+	
+	ulong decodedLength = Base64UrlUnpadded::decodeBufferLenient("Y W\nJ-_w", decoded, 8);
+	if(decodedLength != 4 || memcmp(decoded, "ab~\xff", 4) != 0)
+		throw std::runtime_error("Base64 alphabets test failed: Decoding an unpadded encoding with whitespace gave a wrong result.");
+	
+	//	Without padding, a length error can't say the length should be a multiple of 4, since 6 characters are fine
+	std::string error;
+	try
+	{
+		Base64UrlUnpadded::decodeBuffer("YWJjY", decoded, 5);
+	}
+	catch(std::runtime_error& e)
+	{
+		error = e.what();
+	}
+	
+	if(error != "The length of the base64-encoded line (5) leaves a single character in its last block." ||
+		Base64UrlUnpadded::decodeBuffer("YWJjYQ", decoded, 6) != 4)
+		throw std::runtime_error("Base64 alphabets test failed: Decoding 5 characters in unpadded base64url gave \"" + error +
+			"\" instead of a length error worded for unpadded encodings.");
+}
+
+template <class Codec>
+void testConstexprCodec(const char * name)
+{
+	//	At run time, the constexpr methods must agree with the vectorized ones
+	const uint maxBufferLength = 1024;
+	byte buffer[maxBufferLength];
+	char expected[Base64::getEncodedSize(maxBufferLength)];
+	char encoded[Base64::getEncodedSize(maxBufferLength)];
+	byte decoded[maxBufferLength];
+	
+	for(uint i = 0; i < 1000; i++)
+	{
+		uint length = getRandomBuffer(buffer, maxBufferLength);
+		ulong expectedLength = Codec::encodeBuffer(buffer, expected, length);
+		
+		ulong encodedLength = Codec::encodeConstexpr(buffer, encoded, length);
+		if(encodedLength != expectedLength || memcmp(encoded, expected, encodedLength) != 0)
+			throw std::runtime_error(std::string("Base64 constexpr test failed: Encoding a random buffer in ") + name + " gave a different result.");
+		
+		if(Codec::getDecodedSize(encoded, encodedLength) != length)
+			throw std::runtime_error(std::string("Base64 constexpr test failed: The decoded size of a random encoding in ") + name + " is wrong.");
+		
+		ulong decodedLength = Codec::decodeConstexpr(encoded, decoded, encodedLength);
+		if(decodedLength != length || memcmp(decoded, buffer, length) != 0)
+			throw std::runtime_error(std::string("Base64 constexpr test failed: Decoding a random encoding in ") + name + " gave a different result.");
+	}
+}
+
+void testConstexpr()
+{
+	//	Literals and arrays are encoded and decoded at compile time, into arrays of the exact size
+	constexpr auto hello = "SGVsbG8sIHdvcmxkIQ=="_base64;
+	static_assert(hello.size() == 13 && hello[0] == 'H' && hello[12] == '!', "Base64 constexpr test failed");
+	
+	constexpr auto token = Base64UrlUnpadded::decodeLiteral<"-_8">();
+	static_assert(token.size() == 2 && token[0] == 0xFB && token[1] == 0xFF, "Base64 constexpr test failed");
+	
+	constexpr std::array<byte, 4> ruby = { 'R', 'u', 'b', 'y' };
+	constexpr auto encoded = Base64::encodeArray(ruby);
+	static_assert(encoded.size() == 8 && encoded[0] == 'U' && encoded[5] == 'Q' && encoded[7] == '=', "Base64 constexpr test failed");
+	static_assert(Base64UrlUnpadded::encodeArray(ruby).size() == 6, "Base64 constexpr test failed");
+	
+	testConstexprCodec<Base64>("base64");
+	testConstexprCodec<Base64Url>("base64url");
+	testConstexprCodec<Base64UrlUnpadded>("unpadded base64url");
+	
+	//	At run time, invalid encodings throw
+	const char * invalid[] = { "a", "abc", "a===", "ab=c", "=abc", "abcd=bcd", "ab\ncd==" };
+	byte buffer[16];
+	
+	for(uint i = 0; i < sizeof(invalid)/sizeof(invalid[0]); i++)
+	{
+		bool thrown = false;
+		try
+		{
+			Base64::decodeConstexpr(invalid[i], buffer, strlen(invalid[i]));
+		}
+		catch(std::runtime_error&)
+		{
+			thrown = true;
+		}
+		
+		if(!thrown)
+			throw std::runtime_error("Base64 constexpr test failed: Decoding \"" + std::string(invalid[i]) + "\" did not fail.");
+	}
+}
+
 struct TestCase {
 	const char * encoded;
 	const char * decoded;
@@ -209,6 +702,652 @@ const TestCase g_cases[] = {
 	{"", ""}
 };
 
+void testSpans()
+{
+	const uint maxBufferLength = 1024;
+	byte buffer[maxBufferLength];
+	char expected[Base64::getEncodedSize(maxBufferLength)];
+	char encoded[Base64::getEncodedSize(maxBufferLength)];
+	std::byte decoded[maxBufferLength];
+	
+	for(uint i = 0; i < 1000; i++)
+	{
+		uint length = getRandomBuffer(buffer, maxBufferLength);
+		std::span<const std::byte> data(reinterpret_cast<const std::byte *>(buffer), length);
+		ulong expectedLength = Base64::encodeBuffer(buffer, expected, length);
+		
+		std::string string = Base64::encode(data);
+		if(string != std::string(expected, expectedLength))
+			throw std::runtime_error("Base64 spans test failed: encode gave a different result than encodeBuffer.");
+		
+		//	The caller's storage only needs to be as large as the exact size
+		ulong encodedLength = Base64::encodeInto(data, std::span<char>(encoded, Base64::getEncodedSize(length)));
+		if(encodedLength != expectedLength || memcmp(encoded, expected, encodedLength) != 0)
+			throw std::runtime_error("Base64 spans test failed: encodeInto gave a different result than encodeBuffer.");
+		
+		std::vector<std::byte> vector = Base64::decode(string);
+		//	An empty vector can have no storage, and memcmp can't be given a null pointer even for 0 bytes
+		if(vector.size() != length || (length > 0 && memcmp(vector.data(), buffer, length) != 0))
+			throw std::runtime_error("Base64 spans test failed: decode did not give back the original data.");
+		
+		ulong decodedLength = Base64::decodeInto(string, std::span<std::byte>(decoded, length));
+		if(decodedLength != length || memcmp(decoded, buffer, length) != 0)
+			throw std::runtime_error("Base64 spans test failed: decodeInto did not give back the original data.");
+		
+		if(Base64UrlUnpadded::decode(Base64UrlUnpadded::encode(data)).size() != length)
+			throw std::runtime_error("Base64 spans test failed: decoding an unpadded encoding gave the wrong size.");
+	}
+	
+	//	Buffers that are too small are reported instead of overflowed
+	bool thrown = false;
+	try
+	{
+		Base64::decodeInto("YWJjZA==", std::span<std::byte>(decoded, 3));
+	}
+	catch(std::runtime_error&)
+	{
+		thrown = true;
+	}
+	
+	if(!thrown)
+		throw std::runtime_error("Base64 spans test failed: decodeInto did not fail on a buffer that is too small.");
+	
+	thrown = false;
+	try
+	{
+		Base64::encodeInto(std::span<const std::byte>(decoded, 4), std::span<char>(encoded, 7));
+	}
+	catch(std::runtime_error&)
+	{
+		thrown = true;
+	}
+	
+	if(!thrown)
+		throw std::runtime_error("Base64 spans test failed: encodeInto did not fail on a buffer that is too small.");
+}
+
+template <class Codec>
+void testBatchCodec(const char * name)
+{
+	//	Mostly small inputs, including empty ones, with a few that are too large to be gathered
+	for(uint round = 0; round < 200; round++)
+	{
+		uint nInputs = getRandomNumber(0, 300);
+		std::vector<std::string> data(nInputs);
+		std::vector<std::span<const std::byte>> inputs(nInputs);
+		
+		for(uint i = 0; i < nInputs; i++)
+		{
+			data[i].resize(getRandomNumber(0, getRandomNumber(0, 20) == 0 ? 5000 : 70));
+			for(ulong j = 0; j < data[i].size(); j++)
+				data[i][j] = static_cast<char>(rand());
+			
+			inputs[i] = std::span<const std::byte>(reinterpret_cast<const std::byte *>(data[i].data()), data[i].size());
+		}
+		
+		std::vector<char> arena(Codec::getEncodedBatchSize(inputs));
+		std::vector<ulong> offsets(nInputs + 1);
+		ulong arenaLength = Codec::encodeBatch(inputs, arena, offsets);
+		if(arenaLength != arena.size())
+			throw std::runtime_error(std::string("Base64 batch test failed: Encoding a batch in ") + name + " gave the wrong length.");
+		
+		std::vector<std::string_view> encoded(nInputs);
+		for(uint i = 0; i < nInputs; i++)
+		{
+			encoded[i] = std::string_view(arena.data() + offsets[i], offsets[i + 1] - offsets[i]);
+			if(encoded[i] != Codec::encode(inputs[i]))
+				throw std::runtime_error(std::string("Base64 batch test failed: Encoding a batch in ") + name + " gave a different result than encode.");
+		}
+		
+		std::vector<std::byte> decoded(Codec::getDecodedBatchSize(encoded));
+		ulong decodedLength = Codec::decodeBatch(encoded, decoded, offsets);
+		if(decodedLength != decoded.size())
+			throw std::runtime_error(std::string("Base64 batch test failed: Decoding a batch in ") + name + " gave the wrong length.");
+		
+		for(uint i = 0; i < nInputs; i++)
+		{
+			if(offsets[i + 1] - offsets[i] != data[i].size() ||
+				(!data[i].empty() && memcmp(decoded.data() + offsets[i], data[i].data(), data[i].size()) != 0))
+				throw std::runtime_error(std::string("Base64 batch test failed: Decoding a batch in ") + name + " did not give back the original data.");
+		}
+	}
+}
+
+/**
+ * Returns the message of the exception thrown by decoding the specified batch.
+ */
+std::string getDecodeBatchError(const std::vector<std::string_view> & inputs)
+{
+	std::vector<std::byte> arena(Base64::getDecodedBatchSize(inputs));
+	std::vector<ulong> offsets(inputs.size() + 1);
+	
+	try
+	{
+		Base64::decodeBatch(inputs, arena, offsets);
+	}
+	catch(std::runtime_error& e)
+	{
+		return e.what();
+	}
+	
+	return "";
+}
+
+void testBatch()
+{
+	testBatchCodec<Base64>("base64");
+	testBatchCodec<Base64Url>("base64url");
+	testBatchCodec<Base64UrlUnpadded>("unpadded base64url");
+	
+	//	Errors are reported with the index of the input and the offset in it, including padding
+	//	that ends a block other than the last one of an input
+	std::string large(8000, 'A');
+	large[6001] = '*';
+	
+	struct
+	{
+		std::vector<std::string_view> inputs;
+		const char * error;
+	} cases[] = {
+		{ { "YQ==", "YWJj", "YW*j", "YWJj" }, "Input #2 of the batch: The input string is not a valid base64 encoding: invalid character '*' (ASCII code: 42) at offset 2." },
+		{ { "YQ==", "YWJjYW*j", "YW*j" }, "Input #1 of the batch: The input string is not a valid base64 encoding: invalid character '*' (ASCII code: 42) at offset 6." },
+		{ { "YWJj", "YQ==YWJj" }, "Input #1 of the batch: The input string is not a valid base64 encoding: invalid character '=' (ASCII code: 61) at offset 2." },
+		{ { "YWJjYW*j", "YWJj" }, "Input #0 of the batch: The input string is not a valid base64 encoding: invalid character '*' (ASCII code: 42) at offset 6." },
+		{ { "YWJj", "YWJjY" }, "Input #1 of the batch: The length of the base64-encoded line (5) is not a multiple of 4." },
+		{ { "YWJj", large }, "Input #1 of the batch: The input string is not a valid base64 encoding: invalid character '*' (ASCII code: 42) at offset 6001." }
+	};
+	
+	for(uint i = 0; i < sizeof(cases)/sizeof(cases[0]); i++)
+	{
+		std::string error = getDecodeBatchError(cases[i].inputs);
+		if(error != cases[i].error)
+			throw std::runtime_error("Base64 batch test failed: Expected \"" + std::string(cases[i].error) + "\" but got \"" + error + "\" instead.");
+	}
+}
+
+void testErrorCodes()
+{
+	static_assert(noexcept(Base64::tryDecodeBuffer(NULL, NULL, 0)), "Base64 error codes test failed");
+	static_assert(noexcept(Base64::tryDecode("", std::span<std::byte>())), "Base64 error codes test failed");
+	
+	struct
+	{
+		const char * input;
+		Base64::DecodeError error;
+		ulong offset;
+		ulong length;
+	} cases[] = {
+		{ "", Base64::DECODE_OK, 0, 0 },
+		{ "YWJjZA==", Base64::DECODE_OK, 0, 4 },
+		{ "YWJjZGVm", Base64::DECODE_OK, 0, 6 },
+		{ "YWJjZ", Base64::INVALID_LENGTH, 5, 0 },
+		{ "YWJj*A==", Base64::INVALID_CHARACTER, 4, 0 },
+		{ "YQ==YWJj", Base64::INVALID_CHARACTER, 2, 0 },
+		{ "YWJjZGVmYWJjZGVmYWJjZGVmYWJjZGVmYWJjZGVmYWJjZGVmYWJjZGVmYWJjZGVm\xFF", Base64::INVALID_LENGTH, 65, 0 },
+		{ "YWJjZGVmYWJjZGVmYWJjZGVmYWJjZGVmYWJjZGVmYWJjZGVmYWJjZGVmYWJjZG\xFFm", Base64::INVALID_CHARACTER, 62, 0 }
+	};
+	
+	byte buffer[64];
+	
+	for(uint i = 0; i < sizeof(cases)/sizeof(cases[0]); i++)
+	{
+		Base64::DecodeResult result = Base64::tryDecodeBuffer(cases[i].input, buffer, strlen(cases[i].input));
+		if(result.error != cases[i].error || result.offset != cases[i].offset || result.length != cases[i].length)
+		{
+			std::ostringstream error;
+			error << "Base64 error codes test failed: Decoding \"" << cases[i].input << "\" gave error " << result.error
+				<< " at offset " << result.offset << " with length " << result.length << ".";
+			throw std::runtime_error(error.str());
+		}
+	}
+	
+	//	A buffer that is too small reports the size it needs
+	std::byte decoded[8];
+	Base64::DecodeResult result = Base64::tryDecode("YWJjZGVm", std::span<std::byte>(decoded, 5));
+	if(result.error != Base64::OUTPUT_TOO_SMALL || result.length != 6)
+		throw std::runtime_error("Base64 error codes test failed: Decoding into a buffer that is too small was not reported.");
+	
+	result = Base64::tryDecode("YWJjZGVm", std::span<std::byte>(decoded, 6));
+	if(result.error != Base64::DECODE_OK || result.length != 6 || memcmp(decoded, "abcdef", 6) != 0)
+		throw std::runtime_error("Base64 error codes test failed: Decoding into a buffer of the exact size failed.");
+}
+
+template <class Codec>
+void testValidationCodec(const char * name)
+{
+	//	Validating must report exactly what decoding reports, on every supported backend
+	const uint maxBufferLength = 2048;
+	byte buffer[maxBufferLength];
+	char encoded[Base64::getEncodedSize(maxBufferLength)];
+	byte decoded[maxBufferLength];
+	
+	for(uint i = 0; i < 2000; i++)
+	{
+		uint length = getRandomBuffer(buffer, maxBufferLength);
+		ulong encodedLength = Codec::encodeBuffer(buffer, encoded, length);
+		
+		//	Most encodings get a few random characters, which may or may not be in the alphabet
+		uint nErrors = i % 4 == 0 ? 0 : getRandomNumber(1, 4);
+		for(uint j = 0; j < nErrors && encodedLength > 0; j++)
+			encoded[getRandomNumber(0, encodedLength)] = j % 2 ? '=' : static_cast<char>(rand());
+		
+		if(i % 10 == 0 && encodedLength > 0)
+			encodedLength--;
+		
+		forEachBackend([&](Base64::Backend backend)
+		{
+			Base64::DecodeResult expected = Codec::tryDecodeBuffer(encoded, decoded, encodedLength);
+			Base64::DecodeResult result = Codec::validateEncoding(encoded, encodedLength);
+			
+			if(result.error != expected.error || result.offset != expected.offset || result.length != expected.length ||
+				Codec::isValidEncoding(encoded, encodedLength) != (expected.error == Base64::DECODE_OK))
+			{
+				std::ostringstream error;
+				error << "Base64 validation test failed: The " << Base64::getBackendName(backend) << " backend validated a "
+					<< name << " encoding with error " << result.error << " at offset " << result.offset
+					<< ", but decoding it gave error " << expected.error << " at offset " << expected.offset << ".";
+				throw std::runtime_error(error.str());
+			}
+		});
+	}
+}
+
+void testValidation()
+{
+	testValidationCodec<Base64>("base64");
+	testValidationCodec<Base64Url>("base64url");
+	testValidationCodec<Base64UrlUnpadded>("unpadded base64url");
+}
+
+/**
+ * Checks one operation's statistics against what the test expects them to be.
+ */
+void checkOperationStats(const Base64::Stats & stats, Base64::Operation op, ulong calls, ulong errors, ulong bytesIn,
+	ulong bytesOut)
+{
+	const Base64::OperationStats & opStats = stats.operations[op];
+	
+	ulong nErrors = 0, nTimed = 0;
+	for(uint i = 0; i < Base64::NUM_DECODE_ERRORS; i++)
+		nErrors += opStats.errors[i];
+	for(uint i = 0; i < Base64::NUM_LATENCY_BUCKETS; i++)
+		nTimed += opStats.latency[i];
+	
+	if(opStats.calls != calls || nErrors != errors || opStats.bytesIn != bytesIn || opStats.bytesOut != bytesOut ||
+		nTimed != calls || opStats.failures != 0)
+	{
+		std::ostringstream error;
+		error << "Base64 stats test failed: " << Base64::getOperationName(op) << " has " << opStats.calls << " calls, "
+			<< nErrors << " errors, " << opStats.bytesIn << " bytes in, " << opStats.bytesOut << " bytes out and "
+			<< nTimed << " timed calls instead of " << calls << " calls, " << errors << " errors, " << bytesIn
+			<< " bytes in, " << bytesOut << " bytes out and " << calls << " timed calls.";
+		throw std::runtime_error(error.str());
+	}
+}
+
+void testStats()
+{
+	char encoded[64];
+	byte decoded[64];
+	std::byte small[1];
+	
+	//	Nothing is counted while the statistics are off
+	Base64::setStatsEnabled(false);
+	Base64::resetStats();
+	Base64::encodeBuffer(reinterpret_cast<const byte *>("abcd"), encoded, 4);
+	checkOperationStats(Base64::getStats(), Base64::ENCODE_BUFFER, 0, 0, 0, 0);
+	
+	Base64::setStatsEnabled(true);
+	
+	try
+	{
+		Base64::encodeBuffer(reinterpret_cast<const byte *>("abcdefghij"), encoded, 10);
+		Base64::decodeBuffer("YWJjZA==", decoded, 8);
+		Base64::tryDecodeBuffer("YW*j", decoded, 4);
+		Base64::tryDecode("YWJj", small);
+		Base64::isValidEncoding("YWJj", 4);
+		Base64::isValidEncoding("YWJjY", 5);
+		
+		try
+		{
+			Base64::decodeBuffer("YWJjY", decoded, 5);
+		}
+		catch(std::runtime_error &)
+		{
+		}
+		
+		//	The calls of another thread are counted once it's gone too
+		std::thread thread([]()
+		{
+			char out[8];
+			Base64Url::encodeBuffer(reinterpret_cast<const byte *>("ab"), out, 2);
+		});
+		thread.join();
+		
+		//	A batch counts as one call, not as the encodeBuffer calls it makes
+		std::span<const std::byte> inputs[] = { std::as_bytes(std::span("abc", 3)), std::as_bytes(std::span("de", 2)) };
+		ulong offsets[3];
+		Base64::encodeBatch(inputs, std::span<char>(encoded, sizeof(encoded)), offsets);
+		
+		std::string_view encodedInputs[] = { "YWJj", "ZA*=" };
+		try
+		{
+			Base64::decodeBatch(encodedInputs, std::span<std::byte>(reinterpret_cast<std::byte *>(decoded), sizeof(decoded)), offsets);
+		}
+		catch(std::runtime_error &)
+		{
+		}
+		
+		Base64::decodeBufferLenient("YW Jj\n", decoded, 6);
+	}
+	catch(...)
+	{
+		Base64::setStatsEnabled(false);
+		throw;
+	}
+	
+	Base64::setStatsEnabled(false);
+	
+	Base64::Stats stats = Base64::getStats();
+	checkOperationStats(stats, Base64::ENCODE_BUFFER, 3, 0, 17, 28);
+	checkOperationStats(stats, Base64::DECODE_BUFFER, 6, 4, 14, 7);
+	checkOperationStats(stats, Base64::VALIDATE_ENCODING, 2, 1, 4, 3);
+	checkOperationStats(stats, Base64::ENCODE_FILE, 0, 0, 0, 0);
+	
+	if(stats.operations[Base64::DECODE_BUFFER].errors[Base64::OUTPUT_TOO_SMALL] != 1 ||
+		stats.operations[Base64::DECODE_BUFFER].errors[Base64::INVALID_CHARACTER] != 2)
+		throw std::runtime_error("Base64 stats test failed: The decoding errors were not counted by kind.");
+	
+	if(stats.backend != Base64::getBackend())
+		throw std::runtime_error("Base64 stats test failed: The stats do not report the backend in use.");
+	
+	Base64::resetStats();
+	checkOperationStats(Base64::getStats(), Base64::DECODE_BUFFER, 0, 0, 0, 0);
+}
+
+/**
+ * Returns the message of the exception decodeBuffer throws on the specified encoding, on the
+ * specified number of threads, or an empty string if it doesn't throw.
+ */
+template <class Codec>
+std::string getParallelDecodeError(const std::string & encoded, std::vector<byte> & decoded, uint nThreads)
+{
+	try
+	{
+		Codec::decodeBuffer(encoded.data(), &decoded[0], encoded.size(), nThreads);
+	}
+	catch(std::runtime_error & e)
+	{
+		return e.what();
+	}
+	
+	return "";
+}
+
+template <class Codec>
+void testParallelCodec(const char * name)
+{
+	const uint threads[] = { 1, 2, 3, 8 };
+	
+	//	Sizes on both sides of the threshold and of the chunk boundaries
+	const ulong sizes[] = { 0, 1, 100, (2 << 20) - 1, 2 << 20, (3 << 18) * 3 + 1, (3 << 18) * 5 + 2, 7000003 };
+	
+	for(uint i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+	{
+		ulong size = sizes[i];
+		std::vector<byte> plain(size + 1);
+		for(ulong j = 0; j < size; j++)
+			plain[j] = static_cast<byte>(rand());
+		
+		std::string expected(Codec::getEncodedSize(size), '\0');
+		Codec::encodeBuffer(&plain[0], &expected[0], size);
+		
+		for(uint t = 0; t < sizeof(threads) / sizeof(threads[0]); t++)
+		{
+			std::string encoded(expected.size(), '\0');
+			std::vector<byte> decoded(size + 1);
+			
+			ulong encodedLength = Codec::encodeBuffer(&plain[0], &encoded[0], size, threads[t]);
+			ulong decodedLength = Codec::decodeBuffer(encoded.data(), &decoded[0], encodedLength, threads[t]);
+			
+			if(encodedLength != expected.size() || encoded != expected || decodedLength != size ||
+				memcmp(&decoded[0], &plain[0], size) != 0)
+			{
+				std::ostringstream error;
+				error << "Base64 parallel test failed: Encoding and decoding " << size << " bytes with " << name
+					<< " on " << threads[t] << " threads did not give back the same data.";
+				throw std::runtime_error(error.str());
+			}
+		}
+		
+		if(size < (2 << 20))
+			continue;
+		
+		//	Errors in two chunks, of which the one at the lowest offset must be reported, and a
+		//	padding character at the end of a chunk that isn't the last one
+		std::vector<byte> decoded(size + 1);
+		std::string invalid[3] = { expected, expected, expected };
+		invalid[0][expected.size() - 10] = '*';
+		invalid[0][(1 << 20) + 5] = '*';
+		invalid[1][(2 << 20) - 1] = '=';
+		invalid[2].resize(expected.size() / 4 * 4 - 3);
+		
+		for(uint j = 0; j < 3; j++)
+		{
+			std::string expectedError = getParallelDecodeError<Codec>(invalid[j], decoded, 1);
+			std::string parallelError = getParallelDecodeError<Codec>(invalid[j], decoded, 4);
+			
+			if(expectedError.empty() || parallelError != expectedError)
+			{
+				std::ostringstream error;
+				error << "Base64 parallel test failed: Decoding invalid " << name << " on 4 threads threw \""
+					<< parallelError << "\" instead of \"" << expectedError << "\".";
+				throw std::runtime_error(error.str());
+			}
+		}
+	}
+}
+
+void testParallel()
+{
+	testParallelCodec<Base64>("base64");
+	testParallelCodec<Base64UrlUnpadded>("unpadded base64url");
+}
+
+/**
+ * Splits the specified size into random fragment sizes, with some empty and 1-byte fragments.
+ */
+std::vector<ulong> getRandomFragmentSizes(ulong size)
+{
+	std::vector<ulong> sizes;
+	while(size > 0)
+	{
+		ulong fragmentSize = rand() % 4 == 0 ? rand() % 3 : getRandomNumber(1, 200);
+		if(fragmentSize > size)
+			fragmentSize = size;
+		
+		sizes.push_back(fragmentSize);
+		size -= fragmentSize;
+	}
+	
+	return sizes;
+}
+
+template <class Codec>
+void testFragmentsCodec(const char * name)
+{
+	const uint maxBufferLength = 2000;
+	byte buffer[maxBufferLength];
+	char expected[maxBufferLength * 2];
+	char encoded[maxBufferLength * 2];
+	std::byte decoded[maxBufferLength];
+	
+	for(uint i = 0; i < 500; i++)
+	{
+		uint length = getRandomBuffer(buffer, maxBufferLength);
+		ulong expectedLength = Codec::encodeBuffer(buffer, expected, length);
+		
+		//	Encode from iovecs and decode from string views, both split at random
+		std::vector<iovec> inFragments;
+		std::vector<ulong> sizes = getRandomFragmentSizes(length);
+		for(ulong j = 0, offset = 0; j < sizes.size(); offset += sizes[j++])
+			inFragments.push_back(iovec { buffer + offset, sizes[j] });
+		
+		ulong encodedLength = Codec::encodeFragments(inFragments, std::span<char>(encoded, expectedLength));
+		
+		std::vector<std::string_view> encodedFragments;
+		sizes = getRandomFragmentSizes(encodedLength);
+		for(ulong j = 0, offset = 0; j < sizes.size(); offset += sizes[j++])
+			encodedFragments.push_back(std::string_view(encoded + offset, sizes[j]));
+		
+		ulong decodedLength = Codec::decodeFragments(encodedFragments, std::span<std::byte>(decoded, length));
+		
+		if(encodedLength != expectedLength || memcmp(encoded, expected, expectedLength) != 0 ||
+			decodedLength != length || memcmp(decoded, buffer, length) != 0)
+		{
+			std::ostringstream error;
+			error << "Base64 fragments test failed: Encoding and decoding " << length << " bytes with " << name
+				<< " in fragments did not give back the same data.";
+			throw std::runtime_error(error.str());
+		}
+	}
+}
+
+void testFragments()
+{
+	testFragmentsCodec<Base64>("base64");
+	testFragmentsCodec<Base64Url>("base64url");
+	testFragmentsCodec<Base64UrlUnpadded>("unpadded base64url");
+	
+	//	The span overloads, and the padding split over two fragments
+	std::span<const std::byte> plain[] = { std::as_bytes(std::span("ab", 2)), std::as_bytes(std::span("cd", 2)) };
+	char encoded[8];
+	std::byte decoded[4];
+	
+	if(Base64::encodeFragments(plain, encoded) != 8 || std::string(encoded, 8) != "YWJjZA==")
+		throw std::runtime_error("Base64 fragments test failed: Encoding \"ab\" and \"cd\" did not give \"YWJjZA==\".");
+	
+	std::string_view split[] = { "YWJjZA=", "=" };
+	if(Base64::decodeFragments(split, decoded) != 4 || memcmp(decoded, "abcd", 4) != 0)
+		throw std::runtime_error("Base64 fragments test failed: Decoding \"YWJjZA=\" and \"=\" did not give \"abcd\".");
+	
+	//	Errors are reported at their offset in the whole encoding
+	struct
+	{
+		std::vector<std::string_view> fragments;
+		ulong outSize;
+		const char * error;
+	} invalid[] = {
+		{ { "YWJj", "ZA", "*=" }, 5, "The input string is not a valid base64 encoding: invalid character '*' (ASCII code: 42) at offset 6." },
+		{ { "YWJj", "ZA=" }, 4, "The length of the base64-encoded line (7) is not a multiple of 4." },
+		{ { "YWJjZA=", "=" }, 3, "The output buffer is too small for the decoded data (4 bytes)." }
+	};
+	
+	for(uint i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+	{
+		std::string message;
+		try
+		{
+			Base64::decodeFragments(invalid[i].fragments, std::span<std::byte>(decoded, invalid[i].outSize));
+		}
+		catch(std::runtime_error & e)
+		{
+			message = e.what();
+		}
+		
+		if(message != invalid[i].error)
+			throw std::runtime_error("Base64 fragments test failed: Expected the error \"" + std::string(invalid[i].error) +
+				"\" but got \"" + message + "\".");
+	}
+}
+
+template <class Codec>
+void testInPlaceCodec(const char * name)
+{
+	for(uint i = 0; i < 200; i++)
+	{
+		//	Sizes up to a few blocks, with every remainder of 3
+		ulong size = i < 100 ? i : getRandomNumber(0, 20000);
+		std::vector<byte> plain(size + 1);
+		for(ulong j = 0; j < size; j++)
+			plain[j] = static_cast<byte>(rand());
+		
+		std::string expected(Codec::getEncodedSize(size), '\0');
+		Codec::encodeBuffer(&plain[0], &expected[0], size);
+		
+		forEachBackend([&](Base64::Backend backend)
+		{
+			std::vector<std::byte> buffer(expected.size() + 1);
+			memcpy(&buffer[0], &plain[0], size);
+			
+			ulong encodedLength = Codec::encodeInPlace(std::span<std::byte>(&buffer[0], expected.size()), size);
+			bool encodedOk = encodedLength == expected.size() && memcmp(&buffer[0], expected.data(), encodedLength) == 0;
+			
+			ulong decodedLength = Codec::decodeInPlace(std::span<char>(reinterpret_cast<char *>(&buffer[0]), encodedLength));
+			
+			if(!encodedOk || decodedLength != size || memcmp(&buffer[0], &plain[0], size) != 0)
+			{
+				std::ostringstream error;
+				error << "Base64 in-place test failed: Encoding and decoding " << size << " bytes with " << name
+					<< " in place on the " << Base64::getBackendName(backend) << " backend did not give back the same data.";
+				throw std::runtime_error(error.str());
+			}
+			
+			//	Errors are the ones decodeBuffer reports, including padding at the end of a block
+			if(expected.size() < 8)
+				return;
+			
+			std::string invalid = expected;
+			ulong errorOffset = i % 2 ? getRandomNumber(0, invalid.size() - 2) : 4096 - 1;
+			if(errorOffset < invalid.size() - 2)
+				invalid[errorOffset] = i % 4 < 2 ? '=' : '*';
+			
+			std::string expectedError, inPlaceError;
+			std::vector<byte> decoded(size + 1);
+			try
+			{
+				Codec::decodeBuffer(invalid.data(), &decoded[0], invalid.size());
+			}
+			catch(std::runtime_error & e)
+			{
+				expectedError = e.what();
+			}
+			
+			try
+			{
+				Codec::decodeInPlace(invalid);
+			}
+			catch(std::runtime_error & e)
+			{
+				inPlaceError = e.what();
+			}
+			
+			if(inPlaceError != expectedError)
+				throw std::runtime_error("Base64 in-place test failed: Decoding in place threw \"" + inPlaceError +
+					"\" instead of \"" + expectedError + "\".");
+		});
+	}
+	
+	//	The buffer must have room for the encoding
+	std::byte small[4];
+	try
+	{
+		Codec::encodeInPlace(small, 4);
+	}
+	catch(std::runtime_error &)
+	{
+		return;
+	}
+	
+	throw std::runtime_error("Base64 in-place test failed: Encoding into a buffer that's too small didn't throw.");
+}
+
+void testInPlace()
+{
+	testInPlaceCodec<Base64>("base64");
+	testInPlaceCodec<Base64UrlUnpadded>("unpadded base64url");
+}
+
 void testEncodings()
 {
 	uint size = sizeof(g_cases)/sizeof(g_cases[0]);
@@ -261,6 +1400,23 @@ int main(int argc, char ** argv)
 	tests["3. test_encoding"] = testEncodings;
 	tests["4. test_decoding"] = testDecodings;
 	tests["5. fuzzy"] = fuzzyTest;
+	tests["6. invalid_decoding"] = testInvalidDecodings;
+	tests["7. backends"] = testBackends;
+	tests["8. streaming"] = testStreaming;
+	tests["9. files"] = testFiles;
+	tests["10. file_errors"] = testFileErrors;
+	tests["11. file_layouts"] = testFileLayouts;
+	tests["12. lenient"] = testLenient;
+	tests["13. alphabets"] = testAlphabets;
+	tests["14. constexpr"] = testConstexpr;
+	tests["15. spans"] = testSpans;
+	tests["16. batch"] = testBatch;
+	tests["17. error_codes"] = testErrorCodes;
+	tests["18. validation"] = testValidation;
+	tests["19. stats"] = testStats;
+	tests["20. parallel"] = testParallel;
+	tests["21. fragments"] = testFragments;
+	tests["22. in_place"] = testInPlace;
 	
 	//	Run each test, displaying a success or an error message.
 	bool allGood = true;
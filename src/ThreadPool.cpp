@@ -0,0 +1,157 @@
+/**
+ *	File:		ThreadPool.cpp
+ *	Author:		Alin Tomescu, tomescu.alin@gmail.com
+ *	Website:	http://alinush.org
+ *	Date: 		October 16th, 2026
+ *	License:	Free to use and distribute as long as this notice is kept.
+ */
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+/**
+ * A call to parallelFor, which the workers help with.
+ */
+struct ParallelJob
+{
+	const std::function<void (ulong)> * task;
+	ulong nTasks;
+	std::atomic<ulong> nextTask;
+	std::atomic<bool> failed;
+	std::exception_ptr error;
+	std::mutex errorLock;
+	
+	/**
+	 * The number of workers the job still wants, and the number of workers running its
+	 * tasks, both guarded by the pool's lock.
+	 */
+	uint nWanted;
+	uint nActive;
+};
+
+/**
+ * The worker threads and the jobs waiting for them. The pool is never destroyed, so the
+ * workers, which never exit, can't outlive it.
+ */
+struct WorkerPool
+{
+	std::mutex lock;
+	std::condition_variable jobPosted;
+	std::condition_variable workerDone;
+	std::deque<ParallelJob *> jobs;
+	uint nWorkers = 0;
+};
+
+static WorkerPool & workerPool()
+{
+	static WorkerPool * pool = new WorkerPool();
+	return *pool;
+}
+
+/**
+ * Runs the tasks of the job until there are none left or one of them threw.
+ */
+static void runTasks(ParallelJob & job)
+{
+	for(ulong i = job.nextTask++; i < job.nTasks && !job.failed; i = job.nextTask++)
+	{
+		try
+		{
+			(*job.task)(i);
+		}
+		catch(...)
+		{
+			std::lock_guard<std::mutex> guard(job.errorLock);
+			if(!job.failed.exchange(true))
+				job.error = std::current_exception();
+		}
+	}
+}
+
+static void runWorker()
+{
+	WorkerPool & pool = workerPool();
+	std::unique_lock<std::mutex> lock(pool.lock);
+	
+	for(;;)
+	{
+		pool.jobPosted.wait(lock, [&]() { return !pool.jobs.empty(); });
+		
+		ParallelJob * job = pool.jobs.front();
+		if(--job->nWanted == 0)
+			pool.jobs.pop_front();
+		job->nActive++;
+		
+		lock.unlock();
+		runTasks(*job);
+		lock.lock();
+		
+		if(--job->nActive == 0)
+			pool.workerDone.notify_all();
+	}
+}
+
+void ThreadPool::parallelFor(ulong nTasks, uint nThreads, const std::function<void (ulong)> & task)
+{
+	if(nThreads > nTasks)
+		nThreads = nTasks;
+	
+	/**
+	 * Don't bother with threads when there's nothing to share.
+	 */
+	if(nThreads <= 1)
+	{
+		for(ulong i = 0; i < nTasks; i++)
+			task(i);
+		return;
+	}
+	
+	ParallelJob job;
+	job.task = &task;
+	job.nTasks = nTasks;
+	job.nextTask = 0;
+	job.failed = false;
+	job.nWanted = nThreads - 1;
+	job.nActive = 0;
+	
+	WorkerPool & pool = workerPool();
+	{
+		std::lock_guard<std::mutex> guard(pool.lock);
+		
+		while(pool.nWorkers < nThreads - 1)
+		{
+			std::thread(runWorker).detach();
+			pool.nWorkers++;
+		}
+		
+		pool.jobs.push_back(&job);
+	}
+	
+	for(uint i = 1; i < nThreads; i++)
+		pool.jobPosted.notify_one();
+	
+	runTasks(job);
+	
+	/**
+	 * Workers that didn't get to the job by now have nothing left to do in it,
+	 * so only the ones running its last tasks are waited for.
+	 */
+	{
+		std::unique_lock<std::mutex> lock(pool.lock);
+		
+		std::deque<ParallelJob *>::iterator it = std::find(pool.jobs.begin(), pool.jobs.end(), &job);
+		if(it != pool.jobs.end())
+			pool.jobs.erase(it);
+		
+		pool.workerDone.wait(lock, [&]() { return job.nActive == 0; });
+	}
+	
+	if(job.error)
+		std::rethrow_exception(job.error);
+}
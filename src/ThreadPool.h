@@ -0,0 +1,39 @@
+/**
+ *	File:		ThreadPool.h
+ *	Author:		Alin Tomescu, tomescu.alin@gmail.com
+ *	Website:	http://alinush.org
+ *	Date: 		October 16th, 2026
+ *	License:	Free to use and distribute as long as this notice is kept.
+ */
+#pragma once
+
+#include "Core.h"
+
+#include <functional>
+
+/**
+ * The ThreadPool class runs independent tasks, identified by their index,
+ * on several threads at once. The worker threads are started the first time
+ * they're needed and kept for later calls, which only have to wake them up.
+ */
+class ThreadPool
+{
+	public:
+		/**
+		 * Runs task(0), task(1), ..., task(nTasks - 1) on up to nThreads threads, the calling
+		 * thread included, and waits for all of them to finish. The threads pick the tasks in
+		 * order, one at a time, so tasks of uneven size still keep all the threads busy.
+		 *
+		 * The calling thread starts on the tasks right away and the workers join in as they
+		 * become free, so several threads can call parallelFor at once, and tasks can call it
+		 * too, without waiting on each other's workers.
+		 *
+		 * If a task throws, no more tasks are started and the first exception is rethrown
+		 * once the running tasks finish.
+		 *
+		 * @param	nTasks		the number of tasks to run
+		 * @param	nThreads	the maximum number of threads to run them on
+		 * @param	task		the function running a task, given its index
+		 */
+		static void parallelFor(ulong nTasks, uint nThreads, const std::function<void (ulong)> & task);
+};
@@ -8,36 +8,148 @@
 #include <iostream>
 #include <stdexcept>
 #include <cstring>
-using namespace std;
+#include <cstdlib>
+#include <cctype>
+#include <thread>
+using std::cerr;
+using std::cout;
+using std::endl;
 
 #include "Base64.h"
 
+/**
+ * Prints the statistics of every operation that was called, with the number of calls of each
+ * latency bucket that has any, to the standard error.
+ */
+void printStats()
+{
+	Base64::Stats stats = Base64::getStats();
+	cerr << "backend: " << Base64::getBackendName(stats.backend) << endl;
+	
+	for(int op = 0; op < Base64::NUM_OPERATIONS; op++)
+	{
+		const Base64::OperationStats & opStats = stats.operations[op];
+		if(opStats.calls == 0)
+			continue;
+		
+		cerr << Base64::getOperationName(static_cast<Base64::Operation>(op)) << ": " << opStats.calls << " calls, "
+			<< opStats.failures << " failures, " << opStats.errors[Base64::INVALID_LENGTH] << " invalid lengths, "
+			<< opStats.errors[Base64::INVALID_CHARACTER] << " invalid characters, "
+			<< opStats.errors[Base64::OUTPUT_TOO_SMALL] << " outputs too small, "
+			<< opStats.bytesIn << " bytes in, " << opStats.bytesOut << " bytes out" << endl;
+		
+		for(uint i = 0; i < Base64::NUM_LATENCY_BUCKETS; i++)
+		{
+			if(opStats.latency[i] > 0)
+				cerr << "  < 2^" << i << " ns: " << opStats.latency[i] << endl;
+		}
+	}
+}
+
+/**
+ * Prints how to use the tool to the standard output.
+ */
+void printUsage(const char * name)
+{
+	cout << name << " usage: " << endl;
+	cout << name << " [--mmap] [-j <threads>] [--stats] [/encode | /decode] <input_file> <output_file>" << endl;
+	cout << endl;
+	cout << "  --mmap   encode or decode through memory mappings of the files" << endl;
+	cout << "  -j       encode or decode on the specified number of threads, at least 1 and at most" << endl;
+	cout << "           4 per CPU" << endl;
+	cout << "  --stats  print the statistics of the encoding or decoding to the standard error" << endl;
+}
+
+/**
+ * Parses the number of threads of the -j option, which has to be a positive decimal number.
+ * More threads than 4 per CPU are no faster, so larger numbers are capped at that.
+ *
+ * @return	the number of threads, or 0 if the option is not a valid number of threads
+ */
+uint parseThreads(const char * value)
+{
+	char * end;
+	unsigned long nThreads = strtoul(value, &end, 10);
+	if(!isdigit(static_cast<unsigned char>(value[0])) || *end != '\0' || nThreads == 0)
+		return 0;
+	
+	unsigned long maxThreads = 4 * (std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1);
+	return nThreads < maxThreads ? nThreads : maxThreads;
+}
+
 int main(int argc, char ** argv)
 {
-	if(argc < 4)
+	/**
+	 * Parse the options, which come before the command.
+	 */
+	bool mapped = false;
+	bool stats = false;
+	uint nThreads = 1;
+	int arg = 1;
+	
+	for(; arg < argc && argv[arg][0] == '-'; arg++)
+	{
+		if(strcmp(argv[arg], "--mmap") == 0)
+			mapped = true;
+		else if(strcmp(argv[arg], "--stats") == 0)
+			stats = true;
+		else if(strcmp(argv[arg], "-j") == 0 && arg + 1 < argc)
+		{
+			nThreads = parseThreads(argv[++arg]);
+			if(nThreads == 0)
+			{
+				cerr << "Invalid number of threads: " << argv[arg] << endl;
+				printUsage(argv[0]);
+				return -1;
+			}
+		}
+		else
+		{
+			cerr << "Unknown option: " << argv[arg] << endl;
+			return -1;
+		}
+	}
+	
+	if(argc - arg < 3)
 	{
-		cout << argv[0] << " usage: " << endl;
-		cout << argv[0] << " [/encode | /decode] <input_file> <output_file>" << endl;
+		printUsage(argv[0]);
 		return -1;
 	}
 	else
 	{
+		const char * command = argv[arg];
+		const char * inFile = argv[arg + 1];
+		const char * outFile = argv[arg + 2];
+		
+		Base64::setStatsEnabled(stats);
+		
 		try
 		{
-			if(strcmp(argv[1], "/encode") == 0)
+			if(strcmp(command, "/encode") == 0)
 			{
-				Base64::encodeFile(argv[2], argv[3]);
+				if(mapped)
+					Base64::encodeFileMapped(inFile, outFile, "\r\n", 76, nThreads);
+				else
+					Base64::encodeFile(inFile, outFile, "\r\n", 76, nThreads);
 			}
-			else if(strcmp(argv[1], "/decode") == 0)
+			else if(strcmp(command, "/decode") == 0)
 			{
-				Base64::decodeFile(argv[2], argv[3]);
+				if(mapped)
+					Base64::decodeFileMapped(inFile, outFile, nThreads);
+				else
+					Base64::decodeFile(inFile, outFile, nThreads);
 			}
 		}
 		catch(std::exception& e)
 		{
 			cerr << "Exception occurred: " << e.what() << endl;
+			if(stats)
+				printStats();
 			return -1;
 		}
+		
+		if(stats)
+			printStats();
 	}
 	
 	return 0;